@@ -0,0 +1,171 @@
+// Core 0: calibração da unidade
+//
+// O registro é gravado como está, em páginas inteiras, nos últimos setores
+// da flash; a tabela aplicada por amostra (centro de cada código menos o
+// offset) fica na SRAM e é lida por referência pelo core 1.
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "calibracao.h"
+#include "lib/adc_cal.h"
+#include "lib/meter.h"
+
+#define CAL_FLASH_BYTES ((sizeof(adc_cal_t) + FLASH_SECTOR_SIZE - 1) / FLASH_SECTOR_SIZE * FLASH_SECTOR_SIZE)
+#define CAL_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - CAL_FLASH_BYTES)
+static union
+{
+    adc_cal_t cal;
+    uint8_t paginas[(sizeof(adc_cal_t) + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE * FLASH_PAGE_SIZE];
+} calibracao;
+static uint16_t tabela_correcao_q4[ADC_CAL_CODES];
+static uint32_t cal_referencia_mohm = CAL_R_REF_OHM * 1000u; // Referência do 'k' (CALibration:REFerence)
+
+// Capturas de calibração: armadas aqui, acumuladas no IRQ do core 1
+// (lib/meter.c) e concluídas pela tarefa do console
+static uint8_t canal_calibracao = 0; // Canal usado pelas capturas
+static uint8_t captura_destino;      // 'z' ou 'k': o que a média em andamento ajusta
+static uint32_t captura_hist[ADC_CAL_CODES];
+
+// Sem registro válido usa o ADC ideal e o resistor conhecido nominal
+void calibracao_inicia(void)
+{
+    const adc_cal_t *gravada = (const adc_cal_t *)(XIP_BASE + CAL_FLASH_OFFSET);
+    if (adc_cal_valid(gravada))
+    {
+        calibracao.cal = *gravada;
+    }
+    else
+    {
+        adc_cal_defaults(&calibracao.cal, R_CONHECIDO_PADRAO * 1000u);
+    }
+    adc_cal_build_table(&calibracao.cal, tabela_correcao_q4);
+    meter_init(&calibracao.cal, tabela_correcao_q4);
+}
+
+// Aplica uma calibração nova. A tabela é reescrita com o core 1 rodando: no
+// máximo um bloco mistura entradas antigas e novas.
+static void instala_calibracao(void)
+{
+    adc_cal_seal(&calibracao.cal);
+    adc_cal_build_table(&calibracao.cal, tabela_correcao_q4);
+    meter_calibration_changed();
+}
+
+static void aplica_calibracao(void)
+{
+    instala_calibracao();
+    printf("Calibracao: R_conhecido");
+    for (int c = 0; c < CANAIS; c++)
+    {
+        printf(" %lu", (unsigned long)calibracao.cal.r_known_mohm[c]);
+    }
+    printf(" mohm, offset %ld/16, linear %u-%u\n", (long)calibracao.cal.offset_q4, calibracao.cal.lin_first,
+           calibracao.cal.lin_last);
+}
+
+// Grava com o core 1 pausado (roda da RAM) e as interrupções deste core
+// mascaradas
+bool calibracao_grava(void)
+{
+    multicore_lockout_start_blocking();
+    uint32_t status = save_and_disable_interrupts();
+    flash_range_erase(CAL_FLASH_OFFSET, CAL_FLASH_BYTES);
+    flash_range_program(CAL_FLASH_OFFSET, calibracao.paginas, sizeof(calibracao.paginas));
+    restore_interrupts(status);
+    multicore_lockout_end_blocking();
+    return adc_cal_valid((const adc_cal_t *)(XIP_BASE + CAL_FLASH_OFFSET));
+}
+
+void calibracao_define_canal(uint8_t canal)
+{
+    canal_calibracao = canal;
+    printf("Calibracao no canal %d (GPIO %d)\n", canal + 1, 26 + METER_ADC_FIRST_INPUT + canal);
+}
+
+// Arma uma captura de média; concluída por calibracao_conclui()
+static void inicia_media(uint8_t destino, const uint16_t *tabela)
+{
+    captura_destino = destino;
+    meter_capture_mean(canal_calibracao, tabela);
+}
+
+void calibracao_captura_offset(void)
+{
+    inicia_media('z', calibracao.cal.center_q4); // Sem o offset antigo
+}
+
+void calibracao_captura_referencia(void)
+{
+    inicia_media('k', tabela_correcao_q4);
+}
+
+void calibracao_conclui(void)
+{
+    uint32_t media_q4;
+    if (!meter_capture_mean_done(&media_q4))
+    {
+        return;
+    }
+    if (captura_destino == 'z')
+    {
+        calibracao.cal.offset_q4 = media_q4; // Ponta em curto: deveria ler 0
+    }
+    else
+    {
+        uint32_t r = adc_cal_r_known_mohm(media_q4, cal_referencia_mohm);
+        if (r == 0)
+        {
+            printf("Referencia fora da faixa\n");
+            return;
+        }
+        calibracao.cal.r_known_mohm[canal_calibracao] = r;
+    }
+    aplica_calibracao();
+}
+
+// Liga/desliga a varredura de linearidade; no fim monta a tabela
+void calibracao_alterna_linearidade(void)
+{
+    if (meter_capture_kind() != METER_CAPTURE_HIST)
+    {
+        memset(captura_hist, 0, sizeof(captura_hist));
+        meter_capture_hist(canal_calibracao, captura_hist);
+        printf("Linearidade: varra a entrada devagar e envie 'l' de novo\n");
+        return;
+    }
+    meter_capture_stop();
+    sleep_ms(2); // Deixa terminar um bloco em andamento no core 1
+    if (adc_cal_linearize(&calibracao.cal, captura_hist))
+    {
+        aplica_calibracao();
+    }
+    else
+    {
+        printf("Linearidade: varredura insuficiente\n");
+    }
+}
+
+uint32_t calibracao_r_conhecido(uint8_t canal)
+{
+    return calibracao.cal.r_known_mohm[canal];
+}
+
+void calibracao_define_r_conhecido(uint8_t canal, uint32_t mohm)
+{
+    calibracao.cal.r_known_mohm[canal] = mohm;
+    instala_calibracao();
+}
+
+uint32_t calibracao_referencia(void)
+{
+    return cal_referencia_mohm;
+}
+
+void calibracao_define_referencia(uint32_t mohm)
+{
+    cal_referencia_mohm = mohm;
+}
@@ -0,0 +1,36 @@
+#ifndef CALIBRACAO_H
+#define CALIBRACAO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Core 0: calibração da unidade (offset, resistor conhecido por canal e
+// linearidade do ADC), gravada nos últimos setores da flash. As capturas
+// são armadas aqui e acumuladas no IRQ do core 1 (lib/meter.c).
+
+#define R_CONHECIDO_PADRAO 10000   // Resistor de 10k ohm (sem calibração gravada)
+#define CAL_R_REF_OHM 10000        // Referência de precisão usada no comando 'k' (padrão)
+
+// Carrega a calibração gravada (ou a ideal) e a entrega a lib/meter.c;
+// antes de lançar o core 1
+void calibracao_inicia(void);
+// Grava na flash; false se a releitura não confere
+bool calibracao_grava(void);
+
+// Capturas no canal escolhido: 'z' offset (ponta em curto), 'k' resistor
+// conhecido (referência na ponta) e 'l' varredura de linearidade. O console
+// chama calibracao_conclui() periodicamente para aplicar o resultado.
+void calibracao_define_canal(uint8_t canal);
+void calibracao_captura_offset(void);
+void calibracao_captura_referencia(void);
+void calibracao_alterna_linearidade(void);
+void calibracao_conclui(void);
+
+// Ajustes pelo console SCPI (em mΩ); o resistor conhecido vale na hora, só
+// na RAM, até calibracao_grava()
+uint32_t calibracao_r_conhecido(uint8_t canal);
+void calibracao_define_r_conhecido(uint8_t canal, uint32_t mohm);
+uint32_t calibracao_referencia(void);
+void calibracao_define_referencia(uint32_t mohm);
+
+#endif
@@ -0,0 +1,10 @@
+# Tabelas das séries E (E6..E192) geradas em tempo de build por
+# tools/gen_e_series.py; o arquivo gerado fica em E_SERIES_TABLE
+find_package(Python3 REQUIRED COMPONENTS Interpreter)
+set(E_SERIES_TABLE ${CMAKE_CURRENT_BINARY_DIR}/e_series_table.c)
+add_custom_command(
+        OUTPUT ${E_SERIES_TABLE}
+        COMMAND Python3::Interpreter ${CMAKE_CURRENT_LIST_DIR}/../tools/gen_e_series.py ${E_SERIES_TABLE}
+        DEPENDS ${CMAKE_CURRENT_LIST_DIR}/../tools/gen_e_series.py
+        COMMENT "Gerando tabelas das séries E"
+        )
@@ -0,0 +1,578 @@
+// Core 0: console da USB (teclas de um caractere e comandos SCPI) e
+// esvaziamento do anel de telemetria
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "console.h"
+#include "calibracao.h"
+#include "interface.h"
+#include "lib/adc_dma.h"
+#include "lib/meter.h"
+#include "lib/e_series.h"
+#include "lib/probe.h"
+#include "lib/prof.h"
+#include "lib/telemetry.h"
+#include "lib/binning.h"
+#include "lib/scpi.h"
+#include "tusb.h"
+#include "hardware/sync.h"
+
+#define PERIODO_MEDIDA_US 1000     // Console durante um MEASure? (uma leitura por bloco)
+#define MEDIDA_MAX 1000            // Leituras por MEASure?
+#define MEDIDA_TIMEOUT_MS 2000     // Sem leitura nova decidida: a resposta termina
+#define PERIODO_TELEMETRIA_US 1000 // Esvaziamento do anel de telemetria na USB
+#define R_AJUSTE_MIN 100           // Faixa aceita para R_conhecido e a referência pelo console
+#define R_AJUSTE_MAX 1000000
+#define SEPARACAO_TOL_MAX_DECIMOS 200 // Tolerância da separação: até 20%
+
+static scheduler_t *sched_core0;
+static int tarefa_telemetria_id, tarefa_console_id;
+static bool telemetria_ativa = false, gravacao_ativa = false; // Teclas 't' e 'g'
+// Alvo e tolerância da separação pedidos (0 = ensinado pela primeira peça /
+// tolerância da série)
+static uint32_t separacao_nominal_mohm = 0;
+static uint16_t separacao_tol_decimos = 0;
+
+// Contagens e histograma de desvios da separação em CSV (o core 1 pode estar
+// atualizando: uma peça a mais ou a menos não muda a leitura do histograma)
+static void imprime_separacao(void)
+{
+    const binning_t *separacao = meter_binning();
+    printf("# separacao nominal_mohm=%lu tol_decimos=%u\n", (unsigned long)separacao->nominal_mohm,
+           separacao->tolerance_tenths);
+    printf("ok,alto,baixo,errado\n%lu,%lu,%lu,%lu\n", (unsigned long)separacao->counts[BIN_PASS],
+           (unsigned long)separacao->counts[BIN_HIGH], (unsigned long)separacao->counts[BIN_LOW],
+           (unsigned long)separacao->counts[BIN_WRONG]);
+    printf("desvio_ppm_min,pecas\n");
+    for (int i = 0; i < BINNING_HIST_BINS; i++)
+    {
+        printf("%ld,%u\n", (long)(i - BINNING_HIST_BINS / 2) * BINNING_HIST_STEP_PPM, separacao->hist[i]);
+    }
+}
+
+// Esvazia o anel de telemetria direto no FIFO do endpoint CDC, sem cópia
+// intermediária e sem esperar por espaço. O IRQ do stdio_usb também chama o
+// TinyUSB, por isso a escrita é feita com as interrupções mascaradas.
+static void tarefa_telemetria(void *ctx)
+{
+    telemetry_t *telemetria = meter_telemetry();
+    const uint8_t *dados;
+    uint32_t n;
+    while ((n = telemetry_peek(telemetria, &dados)) > 0)
+    {
+        uint32_t status = save_and_disable_interrupts();
+        uint32_t escritos = tud_cdc_connected() ? tud_cdc_write(dados, n) : n; // Sem host: descarta
+        tud_cdc_write_flush();
+        restore_interrupts(status);
+        telemetry_consume(telemetria, escritos);
+        if (escritos < n)
+        {
+            break; // FIFO cheio: continua no próximo período
+        }
+    }
+}
+
+// Teclas de um caractere pela USB: 'p' imprime os tempos por etapa em CSV,
+// 'r' zera as estatísticas (só com OHMIMETRO_PROF), 't' liga/desliga o fluxo
+// binário de telemetria, 'g' liga/desliga a gravação da sessão (todos os
+// blocos e os botões, para host/replay), 'h' imprime contagens e histograma
+// da separação, 'b' o tempo do boot até a primeira leitura.
+// Na varredura '1' a '3' escolhem o canal usado pelas capturas de calibração.
+// Calibração: 'z' offset (ponta em curto), 'k' resistor conhecido (referência
+// calibracao_referencia() na ponta), 'l' inicia/termina a varredura de
+// linearidade, 'w' grava na flash. Retorna false se `c` não é uma tecla.
+static bool tecla(int c)
+{
+    if (c == 'p')
+    {
+        prof_dump_csv();
+    }
+    else if (c == 'r')
+    {
+        prof_reset();
+    }
+    else if (c == 'h')
+    {
+        imprime_separacao();
+    }
+    else if (c >= '1' && c < '1' + CANAIS)
+    {
+        calibracao_define_canal(c - '1');
+    }
+    else if (c == 'b')
+    {
+        printf("Boot: primeira leitura em %lu us\n", (unsigned long)meter_first_reading_us());
+    }
+    else if (c == 'z')
+    {
+        calibracao_captura_offset();
+    }
+    else if (c == 'k')
+    {
+        calibracao_captura_referencia();
+    }
+    else if (c == 'l')
+    {
+        calibracao_alterna_linearidade();
+    }
+    else if (c == 'w')
+    {
+        printf("Calibracao gravada (%s)\n", calibracao_grava() ? "ok" : "falhou");
+    }
+    else if (c == 't' || c == 'g')
+    {
+        if (c == 't')
+        {
+            telemetria_ativa = !telemetria_ativa;
+            meter_set_streaming(telemetria_ativa);
+        }
+        else
+        {
+            gravacao_ativa = !gravacao_ativa;
+            meter_set_recording(gravacao_ativa);
+        }
+        bool envia = telemetria_ativa || gravacao_ativa;
+        sched_set_period(sched_core0, tarefa_telemetria_id, envia ? PERIODO_TELEMETRIA_US : 0);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+// Controle remoto: comandos SCPI por linha na mesma porta USB
+
+static scpi_t console_scpi;
+
+// MEASure? em andamento: cada item é a próxima leitura publicada com estado
+// decidido (a primeira pode ser a atual); os itens saem numa só linha,
+// separados por ';', à medida que chegam. Aberto, curto e HOLD só são
+// publicados na mudança de estado, então valem de novo a cada bloco recebido
+// até a próxima publicação.
+static struct
+{
+    uint32_t restantes;
+    uint32_t enviadas;
+    uint8_t canal;
+    uint32_t versao;
+    uint64_t ultima_us;
+    meter_reading_t ultima;
+    bool repete;     // Última leitura em estado que não é republicado
+    uint32_t bloco;  // meter_blocks() no último item
+} medida;
+
+static const char *const nomes_estado[] = {"OPEN", "SHORT", "SETTLING", "STABLE", "HOLD"};
+
+// mΩ em Ω com três casas
+static void imprime_ohm(uint32_t mohm)
+{
+    printf("%lu.%03lu", (unsigned long)(mohm / 1000), (unsigned long)(mohm % 1000));
+}
+
+// R_x,incerteza,comercial,série,faixas,estado (faixas vazias sem valor decidido)
+static void imprime_leitura(const meter_reading_t *leitura)
+{
+    bool valor = leitura->estado == PROBE_STABLE || leitura->estado == PROBE_HOLD;
+    imprime_ohm(leitura->r_x_mohm);
+    putchar(',');
+    imprime_ohm(leitura->incerteza_mohm);
+    putchar(',');
+    imprime_ohm(leitura->closest_mohm);
+    printf(",%s,", e_series_tables[leitura->series].name);
+    for (int i = 0; valor && i < leitura->digits; i++)
+    {
+        printf("%u-", leitura->bands[i]);
+    }
+    if (valor && leitura->digits)
+    {
+        printf("%u", leitura->multiplier);
+    }
+    printf(",%s", nomes_estado[leitura->estado]);
+}
+
+static void termina_medida(void)
+{
+    medida.restantes = 0;
+    putchar('\n');
+    sched_set_period(sched_core0, tarefa_console_id, PERIODO_CONSOLE_MS * 1000);
+}
+
+static void envia_item(const meter_reading_t *leitura, uint64_t agora)
+{
+    if (medida.enviadas++)
+    {
+        putchar(';');
+    }
+    imprime_leitura(leitura);
+    medida.ultima_us = agora;
+    medida.restantes--;
+    medida.ultima = *leitura;
+    medida.repete = leitura->estado != PROBE_STABLE;
+    medida.bloco = meter_blocks();
+}
+
+static void continua_medida(void)
+{
+    uint64_t agora = time_us_64();
+    if (meter_version(medida.canal) != medida.versao)
+    {
+        meter_reading_t leitura;
+        uint32_t versao = meter_read(medida.canal, &leitura);
+        if (leitura.estado == PROBE_SETTLING)
+        {
+            medida.repete = false; // Acomodando: espera a decisão
+        }
+        else if (versao != medida.versao)
+        {
+            envia_item(&leitura, agora);
+        }
+        medida.versao = versao;
+    }
+    else if (medida.repete && meter_blocks() != medida.bloco)
+    {
+        envia_item(&medida.ultima, agora);
+    }
+    else if (agora - medida.ultima_us > MEDIDA_TIMEOUT_MS * 1000u)
+    {
+        scpi_error(&console_scpi, SCPI_ERR_TIMEOUT); // A resposta termina com o que houver
+        medida.restantes = 0;
+    }
+    if (medida.restantes == 0)
+    {
+        termina_medida();
+    }
+}
+
+// Número obrigatório com `casas` decimais; sem ele ou inválido, registra o erro
+static bool parametro(scpi_t *s, const char **p, uint8_t casas, uint32_t *valor)
+{
+    if (!scpi_param_present(*p))
+    {
+        scpi_error(s, SCPI_ERR_MISSING_PARAMETER);
+        return false;
+    }
+    if (!scpi_param_fixed(p, casas, valor))
+    {
+        scpi_error(s, SCPI_ERR_DATA_TYPE);
+        return false;
+    }
+    return true;
+}
+
+// Canal opcional (1 a CANAIS, padrão 1) como último parâmetro
+static bool parametro_canal(scpi_t *s, const char *p, uint8_t *canal)
+{
+    uint32_t c = 1;
+    if (scpi_param_present(p) && !parametro(s, &p, 0, &c))
+    {
+        return false;
+    }
+    if (scpi_param_present(p))
+    {
+        scpi_error(s, SCPI_ERR_PARAMETER_NOT_ALLOWED);
+        return false;
+    }
+    if (c < 1 || c > CANAIS)
+    {
+        scpi_error(s, SCPI_ERR_OUT_OF_RANGE);
+        return false;
+    }
+    *canal = c - 1;
+    return true;
+}
+
+static bool fora_da_faixa(scpi_t *s, uint32_t valor, uint32_t min, uint32_t max)
+{
+    if (valor >= min && valor <= max)
+    {
+        return false;
+    }
+    scpi_error(s, SCPI_ERR_OUT_OF_RANGE);
+    return true;
+}
+
+static void comando_idn(scpi_t *s, const char *p)
+{
+    printf("BitDogLab,Ohmimetro,0,canais=%d\n", CANAIS);
+}
+
+static void comando_cls(scpi_t *s, const char *p)
+{
+    while (scpi_pop_error(s))
+    {
+    }
+}
+
+// Parâmetros de volta aos padrões do build (a calibração fica)
+static void comando_rst(scpi_t *s, const char *p)
+{
+    meter_set_series(E_SERIES_E24);
+    meter_set_samples(METER_SAMPLES_DEFAULT);
+    calibracao_define_referencia(CAL_R_REF_OHM * 1000u);
+    interface_define_periodo_render(PERIODO_RENDER_MS);
+    separacao_nominal_mohm = 0;
+    separacao_tol_decimos = 0;
+    meter_set_binning_target(0, 0);
+}
+
+// MEASure? [n[,canal]]: n leituras (1 a MEDIDA_MAX) numa só resposta
+static void comando_medida(scpi_t *s, const char *p)
+{
+    uint32_t n = 1;
+    if (scpi_param_present(p) && !parametro(s, &p, 0, &n))
+    {
+        return;
+    }
+    uint8_t canal;
+    if (fora_da_faixa(s, n, 1, MEDIDA_MAX) || !parametro_canal(s, p, &canal))
+    {
+        return;
+    }
+    medida.restantes = n;
+    medida.enviadas = 0;
+    medida.canal = canal;
+    medida.versao = 0; // A leitura atual já conta, se decidida
+    medida.repete = false;
+    medida.ultima_us = time_us_64();
+    sched_set_period(sched_core0, tarefa_console_id, PERIODO_MEDIDA_US);
+    scpi_defer(s); // O resto da linha espera a resposta
+}
+
+// SERies E6|E12|E24|E48|E96|E192
+static void comando_serie(scpi_t *s, const char *p)
+{
+    char nome[8];
+    if (!scpi_param_present(p))
+    {
+        scpi_error(s, SCPI_ERR_MISSING_PARAMETER);
+        return;
+    }
+    if (scpi_param_word(&p, nome, sizeof(nome)) && !scpi_param_present(p))
+    {
+        for (uint8_t i = 0; i < E_SERIES_COUNT; i++)
+        {
+            if (strcmp(nome, e_series_tables[i].name) == 0)
+            {
+                meter_set_series(i);
+                return;
+            }
+        }
+    }
+    scpi_error(s, SCPI_ERR_ILLEGAL_VALUE);
+}
+
+static void comando_serie_q(scpi_t *s, const char *p)
+{
+    printf("%s\n", e_series_tables[meter_series()].name);
+}
+
+// SAMPles n: leitura decidida a cada n amostras; 0 volta ao adaptativo
+static void comando_amostras(scpi_t *s, const char *p)
+{
+    uint32_t n;
+    if (!parametro(s, &p, 0, &n))
+    {
+        return;
+    }
+    if (n != 0 && fora_da_faixa(s, n, ADC_DMA_BLOCK_SAMPLES, METER_SAMPLES_MAX))
+    {
+        return;
+    }
+    meter_set_samples(n);
+}
+
+static void comando_amostras_q(scpi_t *s, const char *p)
+{
+    printf("%lu\n", (unsigned long)meter_samples());
+}
+
+// blocos,overruns do ADC,pacotes de telemetria descartados,primeira leitura (us)
+static void comando_estatistica_q(scpi_t *s, const char *p)
+{
+    printf("%lu,%lu,%lu,%lu\n", (unsigned long)meter_blocks(), (unsigned long)adc_dma_overruns(),
+           (unsigned long)meter_telemetry()->dropped_packets, (unsigned long)meter_first_reading_us());
+}
+
+static void comando_perfil_q(scpi_t *s, const char *p)
+{
+    prof_dump_csv();
+}
+
+static void comando_perfil_reset(scpi_t *s, const char *p)
+{
+    prof_reset();
+}
+
+// CALibration:RKNown ohm[,canal]: resistor conhecido medido por outro meio
+static void comando_r_conhecido(scpi_t *s, const char *p)
+{
+    uint32_t r;
+    uint8_t canal;
+    if (!parametro(s, &p, 3, &r) || fora_da_faixa(s, r, R_AJUSTE_MIN * 1000u, R_AJUSTE_MAX * 1000u) ||
+        !parametro_canal(s, p, &canal))
+    {
+        return;
+    }
+    calibracao_define_r_conhecido(canal, r); // Só na RAM; CALibration:SAVE grava
+}
+
+static void comando_r_conhecido_q(scpi_t *s, const char *p)
+{
+    uint8_t canal;
+    if (parametro_canal(s, p, &canal))
+    {
+        imprime_ohm(calibracao_r_conhecido(canal));
+        putchar('\n');
+    }
+}
+
+// CALibration:REFerence ohm: valor da referência de precisão usada pelo 'k'
+static void comando_referencia(scpi_t *s, const char *p)
+{
+    uint32_t r;
+    if (parametro(s, &p, 3, &r) && !fora_da_faixa(s, r, R_AJUSTE_MIN * 1000u, R_AJUSTE_MAX * 1000u))
+    {
+        calibracao_define_referencia(r);
+    }
+}
+
+static void comando_referencia_q(scpi_t *s, const char *p)
+{
+    imprime_ohm(calibracao_referencia());
+    putchar('\n');
+}
+
+static void comando_grava(scpi_t *s, const char *p)
+{
+    if (!calibracao_grava())
+    {
+        scpi_error(s, SCPI_ERR_EXECUTION);
+    }
+}
+
+// BINning:NOMinal ohm: alvo da separação; 0 volta a ensinar pela primeira peça
+static void comando_nominal(scpi_t *s, const char *p)
+{
+    uint32_t r;
+    if (!parametro(s, &p, 3, &r) || (r != 0 && fora_da_faixa(s, r, R_AJUSTE_MIN * 1000u, R_AJUSTE_MAX * 1000u)))
+    {
+        return;
+    }
+    separacao_nominal_mohm = r;
+    meter_set_binning_target(separacao_nominal_mohm, separacao_tol_decimos);
+}
+
+// Alvo em uso: o definido ou o ensinado (0 antes da primeira peça)
+static void comando_nominal_q(scpi_t *s, const char *p)
+{
+    imprime_ohm(meter_binning_nominal());
+    putchar('\n');
+}
+
+// BINning:TOLerance pct: tolerância da separação (uma casa); 0 volta à da série
+static void comando_tolerancia(scpi_t *s, const char *p)
+{
+    uint32_t decimos;
+    if (!parametro(s, &p, 1, &decimos) || (decimos != 0 && fora_da_faixa(s, decimos, 1, SEPARACAO_TOL_MAX_DECIMOS)))
+    {
+        return;
+    }
+    separacao_tol_decimos = decimos;
+    meter_set_binning_target(separacao_nominal_mohm, separacao_tol_decimos);
+}
+
+static void comando_tolerancia_q(scpi_t *s, const char *p)
+{
+    uint16_t decimos = meter_binning_tolerance();
+    printf("%u.%u\n", decimos / 10, decimos % 10);
+}
+
+// DISPlay:PERiod ms: verificação de leitura nova para a tela
+static void comando_periodo(scpi_t *s, const char *p)
+{
+    uint32_t ms;
+    if (parametro(s, &p, 0, &ms) && !fora_da_faixa(s, ms, 10, 1000))
+    {
+        interface_define_periodo_render(ms);
+    }
+}
+
+static void comando_periodo_q(scpi_t *s, const char *p)
+{
+    printf("%lu\n", (unsigned long)interface_periodo_render());
+}
+
+static void comando_erro_q(scpi_t *s, const char *p)
+{
+    int16_t codigo = scpi_pop_error(s);
+    printf("%d,\"%s\"\n", codigo, scpi_error_text(codigo));
+}
+
+static const scpi_command_t comandos_scpi[] = {
+    {"*IDN?", comando_idn},
+    {"*CLS", comando_cls},
+    {"*RST", comando_rst},
+    {"MEASure?", comando_medida},
+    {"SERies", comando_serie},
+    {"SERies?", comando_serie_q},
+    {"SAMPles", comando_amostras},
+    {"SAMPles?", comando_amostras_q},
+    {"STATistics?", comando_estatistica_q},
+    {"STATistics:PROFile?", comando_perfil_q},
+    {"STATistics:RESet", comando_perfil_reset},
+    {"CALibration:RKNown", comando_r_conhecido},
+    {"CALibration:RKNown?", comando_r_conhecido_q},
+    {"CALibration:REFerence", comando_referencia},
+    {"CALibration:REFerence?", comando_referencia_q},
+    {"CALibration:SAVE", comando_grava},
+    {"BINning:NOMinal", comando_nominal},
+    {"BINning:NOMinal?", comando_nominal_q},
+    {"BINning:TOLerance", comando_tolerancia},
+    {"BINning:TOLerance?", comando_tolerancia_q},
+    {"DISPlay:PERiod", comando_periodo},
+    {"DISPlay:PERiod?", comando_periodo_q},
+    {"SYSTem:ERRor?", comando_erro_q},
+};
+
+// Console da USB, sem bloquear: no início de uma linha as teclas de um
+// caractere agem na hora; o resto forma uma linha SCPI, executada no '\n'.
+// Enquanto um MEASure? coleta leituras o console roda a cada bloco e não lê
+// mais nada (os bytes esperam no buffer do CDC).
+static void tarefa_console(void *ctx)
+{
+    calibracao_conclui();
+    if (medida.restantes)
+    {
+        continua_medida();
+        if (medida.restantes)
+        {
+            return;
+        }
+    }
+    if (!scpi_run(&console_scpi))
+    {
+        return; // Outro MEASure? no resto da linha
+    }
+    int c;
+    while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT)
+    {
+        if (console_scpi.len == 0 && tecla(c))
+        {
+            continue;
+        }
+        if (scpi_feed(&console_scpi, c) && !scpi_run(&console_scpi))
+        {
+            return;
+        }
+    }
+}
+
+void console_inicia(scheduler_t *sched)
+{
+    sched_core0 = sched;
+    scpi_init(&console_scpi, comandos_scpi, sizeof(comandos_scpi) / sizeof(comandos_scpi[0]));
+    tarefa_console_id = sched_add(sched, "console", tarefa_console, NULL, PERIODO_CONSOLE_MS * 1000);
+    tarefa_telemetria_id = sched_add(sched, "telemetria", tarefa_telemetria, NULL, 0);
+}
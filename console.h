@@ -0,0 +1,16 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include "lib/scheduler.h"
+
+// Core 0: console da USB. No início de uma linha as teclas de um caractere
+// agem na hora; o resto forma uma linha SCPI (lib/scpi.c). A tarefa de
+// telemetria esvazia o anel de lib/meter.c na mesma porta quando o fluxo
+// binário ou a gravação da sessão estão ligados.
+
+#define PERIODO_CONSOLE_MS 100    // Leitura de comandos pela USB
+
+// Adiciona as tarefas do console e da telemetria a `sched`
+void console_inicia(scheduler_t *sched);
+
+#endif
@@ -0,0 +1,427 @@
+// Microbenchmarks da lógica portátil (build no host, -DOHMIMETRO_HOST=ON)
+//
+// Cada caso roda em lotes até somar BENCH_MIN_NS e repete BENCH_REPEATS
+// vezes; o relatório em CSV traz o menor e o mediano ns/op, para comparar
+// execuções ao longo do tempo. As entradas são fixas (sem aleatoriedade).
+//
+// Uso: ohmimetro_bench [filtro]   (só roda os casos cujo nome contém o filtro)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "divider.h"
+#include "e_series.h"
+#include "format.h"
+#include "stats.h"
+#include "robust_filter.h"
+#include "telemetry.h"
+#include "adc_cal.h"
+#include "continuity.h"
+#include "probe.h"
+#include "ssd1306.h"
+#include "ws2818b.h"
+#include "float_ref.h"
+#include "../interface.h"
+
+#define BENCH_MIN_NS 20000000ull // 20 ms por medição
+#define BENCH_REPEATS 7
+
+typedef void (*bench_fn_t)(uint32_t iterations);
+
+typedef struct {
+    const char *name;
+    bench_fn_t fn;
+} bench_t;
+
+static volatile uint32_t sink; // Impede que o compilador descarte os resultados
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// ---------------------------------------------------------------------------
+// Conversão e busca do valor comercial
+// ---------------------------------------------------------------------------
+
+static e_series_lut_t lut_e24, lut_e192;
+
+static void bench_divider_rx(uint32_t n) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+        acc += divider_rx_mohm((i & 4095) * 256, 256, 10000000u);
+    sink = acc;
+}
+
+static void bench_divider_spread(uint32_t n) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+        acc += divider_spread_mohm((i & 4095) << 8, 40, 10000000u);
+    sink = acc;
+}
+
+// Mesma conversão na versão original em float (no RP2040, float em software)
+static void bench_divider_rx_float(uint32_t n) {
+    float acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+        acc += ref_rx_ohm((float)((i & 4095) * 256) / 256.0f);
+    sink = (uint32_t)acc;
+}
+
+// Cadeia completa código -> R_x -> limitação -> E24 -> faixas, em ponto fixo
+// e na versão original em float
+static void bench_chain_fixed(uint32_t n) {
+    uint32_t acc = 0;
+    uint8_t bands[2], multiplier;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t r = divider_clamp(divider_rx_mohm((i & 4095) * 256, 256, 10000000u), 510000u, 100000000u);
+        e_series_bands(e_series_nearest(E_SERIES_E24, r), 2, bands, &multiplier);
+        acc += bands[0] + bands[1] + multiplier;
+    }
+    sink = acc;
+}
+
+static void bench_chain_float(uint32_t n) {
+    uint32_t acc = 0;
+    int b1, b2, m;
+    for (uint32_t i = 0; i < n; i++) {
+        float r = ref_clamp(ref_rx_ohm((float)((i & 4095) * 256) / 256.0f));
+        ref_colors(ref_closest_e24(r), &b1, &b2, &m);
+        acc += b1 + b2 + m;
+    }
+    sink = acc;
+}
+
+static void bench_nearest_e24(uint32_t n) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+        acc += e_series_nearest(E_SERIES_E24, 510000u + (i & 0xFFFF) * 1517u);
+    sink = acc;
+}
+
+static void bench_lut_index_e24(uint32_t n) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+        acc += e_series_lut_index(&lut_e24, (i * 2654435761u) % (4095u << 8));
+    sink = acc;
+}
+
+static void bench_lut_index_e192(uint32_t n) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+        acc += e_series_lut_index(&lut_e192, (i * 2654435761u) % (4095u << 8));
+    sink = acc;
+}
+
+static void bench_bands(uint32_t n) {
+    uint8_t bands[3], multiplier;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        e_series_bands(lut_e192.values_mohm[i % lut_e192.count], 3, bands, &multiplier);
+        acc += bands[0] + multiplier;
+    }
+    sink = acc;
+}
+
+static void bench_format(uint32_t n) {
+    char buffer[16];
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        format_resistance_value(510000u + (i & 0xFFFF) * 1517u, buffer, sizeof(buffer));
+        acc += (uint8_t)buffer[0];
+    }
+    sink = acc;
+}
+
+// ---------------------------------------------------------------------------
+// Filtro e estatística (por bloco de 256 amostras do DMA)
+// ---------------------------------------------------------------------------
+
+static uint16_t bloco[256];
+static robust_filter_t filtro;
+static stats_t estatistica;
+
+static void bench_robust_filter_block(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        robust_filter_block(&filtro, bloco, 256, &estatistica);
+        if (estatistica.n >= STATS_MAX_SAMPLES / 2)
+            stats_reset(&estatistica);
+    }
+    sink = robust_filter_estimate_q8(&filtro);
+}
+
+// Mesmo filtro com a tabela de linearização aplicada por amostra
+static robust_filter_t filtro_corrigido;
+static adc_cal_t calibracao;
+static uint16_t tabela_q4[ADC_CAL_CODES];
+
+static void bench_robust_filter_block_cal(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        robust_filter_block(&filtro_corrigido, bloco, 256, &estatistica);
+        if (estatistica.n >= STATS_MAX_SAMPLES / 2)
+            stats_reset(&estatistica);
+    }
+    sink = robust_filter_estimate_q8(&filtro_corrigido);
+}
+
+static void bench_stats_decision(uint32_t n) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t mean_q8 = stats_mean_q8(&estatistica);
+        uint32_t margin_q8 = (660ull * stats_isqrt(stats_mean_var_q16(&estatistica))) >> 8;
+        acc += e_series_lut_decided(&lut_e24, mean_q8 + (i & 255), margin_q8);
+    }
+    sink = acc;
+}
+
+// Empacotamento de um bloco bruto no anel da telemetria (esvaziado a cada vez)
+static telemetry_t telemetria;
+
+static void bench_telemetry_samples(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        telemetry_put_samples(&telemetria, i, bloco, 256);
+        telemetry_consume(&telemetria, telemetry_pending(&telemetria));
+    }
+    sink = telemetria.packets;
+}
+
+// Bloco da gravação de sessão: escolhe entre compactado e diferenças (o
+// ruído do bloco de teste cabe num nibble, com um escape no pico)
+static void bench_telemetry_block(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        telemetry_put_block(&telemetria, i, i, bloco, 256);
+        telemetry_consume(&telemetria, telemetry_pending(&telemetria));
+    }
+    sink = telemetria.packets;
+}
+
+// Pior caso da continuidade: o bloco inteiro do lado oposto ao estado
+static void bench_continuity_block(uint32_t n) {
+    continuity_t c;
+    continuity_init(&c);
+    c.on_code = 4095;
+    c.off_code = 4095;
+    for (uint32_t i = 0; i < n; i++) {
+        c.closed = false;
+        c.run = 0;
+        continuity_block(&c, bloco, 256);
+    }
+    sink = c.transitions;
+}
+
+// ---------------------------------------------------------------------------
+// Display (framebuffer e montagem dos quadros) e matriz de LEDs
+// ---------------------------------------------------------------------------
+
+static ssd1306_t ssd;
+
+static void bench_ssd_fill(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++)
+        ssd1306_fill(&ssd, i & 1);
+    sink = ssd.ram_buffer[1];
+}
+
+static void bench_ssd_draw_string(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++)
+        ssd1306_draw_string(&ssd, "1:Vermelho", 8, 6 + (i & 15));
+    sink = ssd.ram_buffer[9];
+}
+
+static void bench_ssd_rect(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++)
+        ssd1306_rect(&ssd, 3, 3, 122, 60, true, i & 1);
+    sink = ssd.ram_buffer[9];
+}
+
+static void bench_ssd_line(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++)
+        ssd1306_line(&ssd, 3, i & 63, 123, 63 - (i & 63), true);
+    sink = ssd.ram_buffer[9];
+}
+
+// Leitura decidida como o core 1 publica (10k na E24, marrom, preto e
+// laranja), com R_x e a incerteza variando um pouco a cada quadro
+static const meter_reading_t *leitura_bench(uint32_t i) {
+    static meter_reading_t leituras[CANAIS];
+    meter_reading_t *l = &leituras[0];
+    *l = (meter_reading_t){
+        .media_q8 = (2047 + (i & 3)) << 8,
+        .r_x_mohm = 10000000u + (i & 3) * 10000u,
+        .closest_mohm = 10000000u,
+        .incerteza_mohm = 12000u + (i & 3) * 1000u,
+        .amostras = 256,
+        .series = E_SERIES_E24,
+        .digits = 2,
+        .bands = {1, 0},
+        .multiplier = 3,
+        .estado = PROBE_STABLE,
+    };
+    return leituras;
+}
+
+static void bench_frame_render(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++)
+        render_tela(&ssd, leitura_bench(i), MODO_SIMPLES);
+    sink = ssd.ram_buffer[9];
+}
+
+static void bench_frame_render_advanced(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++)
+        render_tela(&ssd, leitura_bench(i), MODO_AVANCADO);
+    sink = ssd.ram_buffer[9];
+}
+
+// Quadro completo: desenho + montagem do fluxo de I2C só com o que mudou
+static void bench_frame_render_present(uint32_t n) {
+    uint32_t bytes = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        render_tela(&ssd, leitura_bench(i), MODO_SIMPLES);
+        ssd1306_present(&ssd);
+        bytes += ssd.flush_bytes;
+    }
+    sink = bytes;
+}
+
+static void bench_frame_render_advanced_present(uint32_t n) {
+    uint32_t bytes = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        render_tela(&ssd, leitura_bench(i), MODO_AVANCADO);
+        ssd1306_present(&ssd);
+        bytes += ssd.flush_bytes;
+    }
+    sink = bytes;
+}
+
+static void bench_frame_send_full(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++)
+        ssd1306_send_full(&ssd);
+    sink = ssd.flush_bytes;
+}
+
+static void bench_leds_set(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++)
+        for (int led = 0; led < LED_COUNT; led++)
+            set_led(led, i, led, 30);
+    sink = led_frames_sent;
+}
+
+static void bench_leds_repeat_frame(uint32_t n) {
+    set_all_leds(0, 30, 0);
+    write_leds();
+    for (uint32_t i = 0; i < n; i++) {
+        set_all_leds(0, 30, 0);
+        write_leds_async(); // Quadro igual: descartado pela comparação
+    }
+    sink = led_frames_skipped;
+}
+
+static const bench_t benches[] = {
+    {"divider_rx_mohm", bench_divider_rx},
+    {"divider_rx_float", bench_divider_rx_float},
+    {"divider_spread_mohm", bench_divider_spread},
+    {"chain_fixed", bench_chain_fixed},
+    {"chain_float", bench_chain_float},
+    {"e_series_nearest_e24", bench_nearest_e24},
+    {"e_series_lut_index_e24", bench_lut_index_e24},
+    {"e_series_lut_index_e192", bench_lut_index_e192},
+    {"e_series_bands", bench_bands},
+    {"format_resistance_value", bench_format},
+    {"robust_filter_block_256", bench_robust_filter_block},
+    {"robust_filter_block_256_cal", bench_robust_filter_block_cal},
+    {"stats_decision", bench_stats_decision},
+    {"telemetry_put_samples_256", bench_telemetry_samples},
+    {"telemetry_put_block_256", bench_telemetry_block},
+    {"continuity_block_256_worst", bench_continuity_block},
+    {"ssd1306_fill", bench_ssd_fill},
+    {"ssd1306_draw_string_10", bench_ssd_draw_string},
+    {"ssd1306_rect", bench_ssd_rect},
+    {"ssd1306_line", bench_ssd_line},
+    {"frame_render_simple", bench_frame_render},
+    {"frame_render_present", bench_frame_render_present},
+    {"frame_render_advanced", bench_frame_render_advanced},
+    {"frame_render_advanced_present", bench_frame_render_advanced_present},
+    {"frame_send_full", bench_frame_send_full},
+    {"leds_set_25", bench_leds_set},
+    {"leds_repeat_frame", bench_leds_repeat_frame},
+};
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+// Dobra o lote até uma medição durar BENCH_MIN_NS e então repete
+static void run(const bench_t *b) {
+    uint32_t iterations = 1;
+    uint64_t elapsed;
+    for (;;) {
+        uint64_t t0 = now_ns();
+        b->fn(iterations);
+        elapsed = now_ns() - t0;
+        if (elapsed >= BENCH_MIN_NS || iterations >= (1u << 30))
+            break;
+        iterations *= 2;
+    }
+
+    uint64_t samples[BENCH_REPEATS];
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        uint64_t t0 = now_ns();
+        b->fn(iterations);
+        samples[r] = now_ns() - t0;
+    }
+    qsort(samples, BENCH_REPEATS, sizeof(samples[0]), compare_u64);
+    printf("%s,%.2f,%.2f,%lu\n", b->name, (double)samples[0] / iterations,
+           (double)samples[BENCH_REPEATS / 2] / iterations, (unsigned long)iterations);
+}
+
+// O interface.c do firmware (render_tela) vem junto com lib/meter.c, que
+// usa a matriz e o bipe
+void led_anim_stop(void) {
+}
+
+bool led_anim_running(void) {
+    return false;
+}
+
+void buzzer_set(bool on) {
+}
+
+static void setup(void) {
+    e_series_lut_build(&lut_e24, E_SERIES_E24, 10000000, 510, 100000);
+    e_series_lut_build(&lut_e192, E_SERIES_E192, 10000000, 510, 100000);
+
+    // Bloco com ruído determinístico em torno do código 2047 e um pico
+    uint32_t lcg = 12345;
+    for (int i = 0; i < 256; i++) {
+        lcg = lcg * 1103515245u + 12345u;
+        bloco[i] = 2047 + (int)((lcg >> 16) % 7) - 3;
+    }
+    bloco[100] = 4095;
+    robust_filter_init(&filtro, 2, 48, 4);
+    stats_reset(&estatistica);
+    robust_filter_block(&filtro, bloco, 256, &estatistica);
+    telemetry_init(&telemetria);
+    adc_cal_defaults(&calibracao, 10000000u);
+    calibracao.offset_q4 = 40;
+    adc_cal_build_table(&calibracao, tabela_q4);
+    robust_filter_init(&filtro_corrigido, 2, 48, 4);
+    robust_filter_set_correction(&filtro_corrigido, tabela_q4);
+
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, i2c1);
+    ssd1306_config(&ssd);
+    ssd1306_send_full(&ssd);
+    init_leds();
+}
+
+int main(int argc, char **argv) {
+    const char *filter = argc > 1 ? argv[1] : NULL;
+    setup();
+    printf("bench,ns_op_min,ns_op_median,iterations\n");
+    for (size_t i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        if (!filter || strstr(benches[i].name, filter))
+            run(&benches[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,23 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdio.h>
+
+// Verificações dos testes do host: cada falha é impressa e contada, e o
+// main() do teste retorna CHECK_RESULT() para o ctest
+
+static int check_failures;
+
+#define CHECK(cond, ...)                                           \
+    do {                                                           \
+        if (!(cond)) {                                             \
+            fprintf(stderr, "%s:%d: ", __FILE__, __LINE__);        \
+            fprintf(stderr, __VA_ARGS__);                          \
+            fputc('\n', stderr);                                   \
+            check_failures++;                                      \
+        }                                                          \
+    } while (0)
+
+#define CHECK_RESULT() (check_failures ? (fprintf(stderr, "%d falhas\n", check_failures), 1) : 0)
+
+#endif
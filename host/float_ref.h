@@ -0,0 +1,56 @@
+#ifndef FLOAT_REF_H
+#define FLOAT_REF_H
+
+#include <math.h>
+
+// Cadeia de medida original em float (Ohmimetro01.c antes do ponto fixo),
+// só para o teste de exatidão e o benchmark compararem com lib/divider.c
+
+#define REF_R_CONHECIDO 10000
+#define REF_ADC_RESOLUTION 4095
+
+static const float ref_e24[] = {
+    510, 560, 620, 680, 750, 820, 910,
+    1000, 1100, 1200, 1300, 1500, 1600, 1800, 2000, 2200, 2400, 2700, 3000, 3300, 3600, 3900,
+    4300, 4700, 5100, 5600, 6200, 6800, 7500, 8200, 9100,
+    10000, 11000, 12000, 13000, 15000, 16000, 18000, 20000, 22000, 24000, 27000, 30000, 33000, 36000, 39000,
+    43000, 47000, 51000, 56000, 62000, 68000, 75000, 82000, 91000,
+    100000};
+
+static inline float ref_rx_ohm(float media) {
+    return (REF_R_CONHECIDO * media) / (REF_ADC_RESOLUTION - media);
+}
+
+static inline float ref_clamp(float r) {
+    if (r < 510.0f)
+        return 510.0f;
+    if (r > 100000.0f)
+        return 100000.0f;
+    return r;
+}
+
+static inline float ref_closest_e24(float r) {
+    float closest = ref_e24[0];
+    float min_difference = fabsf(r - closest);
+    for (unsigned i = 1; i < sizeof(ref_e24) / sizeof(ref_e24[0]); i++) {
+        float difference = fabsf(r - ref_e24[i]);
+        if (difference < min_difference) {
+            min_difference = difference;
+            closest = ref_e24[i];
+        }
+    }
+    return closest;
+}
+
+static inline void ref_colors(float resistance, int *first_band, int *second_band, int *multiplier) {
+    float normalized = resistance;
+    *multiplier = 0;
+    while (normalized >= 100) {
+        normalized /= 10;
+        (*multiplier)++;
+    }
+    *first_band = (int)(normalized / 10);
+    *second_band = (int)(normalized) % 10;
+}
+
+#endif
@@ -0,0 +1,111 @@
+# Build no host (-DOHMIMETRO_HOST=ON): a lógica portátil de lib/ vira uma
+# biblioteca estática compilada contra os substitutos do Pico SDK em
+# host/include, e o executável ohmimetro_bench mede o custo de cada função.
+# ohmimetro_replay roda o caminho de medição e a interface do firmware sobre
+# uma sessão gravada e os testes (host/test_*.c) rodam pelo ctest.
+
+if (NOT CMAKE_BUILD_TYPE)
+    set(CMAKE_BUILD_TYPE Release) # Benchmarks sem otimização não dizem nada
+endif()
+
+set(HOST_DIR ${CMAKE_CURRENT_LIST_DIR})
+set(LIB_DIR ${CMAKE_CURRENT_LIST_DIR}/../lib)
+
+add_library(ohmimetro_core STATIC
+        ${LIB_DIR}/divider.c # Conversão do divisor em ponto fixo
+        ${LIB_DIR}/e_series.c # Busca do valor comercial mais próximo
+        ${E_SERIES_TABLE}
+        ${LIB_DIR}/format.c # Texto das resistências
+        ${LIB_DIR}/stats.c
+        ${LIB_DIR}/robust_filter.c
+        ${LIB_DIR}/probe.c
+        ${LIB_DIR}/binning.c
+        ${LIB_DIR}/adc_cal.c
+        ${LIB_DIR}/trend.c
+        ${LIB_DIR}/continuity.c
+        ${LIB_DIR}/seqlock.c
+        ${LIB_DIR}/adc_dma.c # Entrega dos blocos (ADC e DMA simulados em pico_host.c)
+        ${LIB_DIR}/telemetry.c # Enquadramento da telemetria
+        ${LIB_DIR}/scpi.c # Comandos do console
+        ${LIB_DIR}/ssd1306.c # Framebuffer e montagem dos quadros do display
+        ${LIB_DIR}/font.c
+        ${LIB_DIR}/ws2818b.c # Buffer da matriz de LEDs
+        ${HOST_DIR}/pico_host.c # Substitutos do SDK
+        )
+target_include_directories(ohmimetro_core PUBLIC ${HOST_DIR}/include ${LIB_DIR})
+target_compile_options(ohmimetro_core PRIVATE -Wall -Wextra -Wno-unused-parameter)
+
+# As telas vêm do próprio interface.c (com lib/meter.c, do qual ele lê as
+# leituras), com o CANAIS do firmware
+add_executable(ohmimetro_bench
+        ${HOST_DIR}/bench.c
+        ${HOST_DIR}/../interface.c
+        ${LIB_DIR}/meter.c
+        ${LIB_DIR}/scheduler.c
+        )
+target_compile_definitions(ohmimetro_bench PRIVATE CANAIS=${OHMIMETRO_CANAIS})
+target_compile_options(ohmimetro_bench PRIVATE -Wall -Wextra -Wno-unused-parameter)
+target_link_libraries(ohmimetro_bench ohmimetro_core)
+
+# Gera um fluxo de telemetria conhecido para conferir o decodificador (o
+# teste telemetry_loopback, abaixo):
+#   ./telemetry_loopback | python3 tools/telemetry_decode.py --check-ramp -
+add_executable(telemetry_loopback ${HOST_DIR}/telemetry_loopback.c)
+target_link_libraries(telemetry_loopback ohmimetro_core)
+
+# Reprodução de uma sessão gravada pelo firmware ('g' no console), com o
+# mesmo número de canais do firmware que gravou (OHMIMETRO_CANAIS):
+#   ./ohmimetro_replay sessao.bin > quadros.csv
+add_executable(ohmimetro_replay
+        ${HOST_DIR}/replay.c
+        ${LIB_DIR}/meter.c # Os mesmos fontes do firmware, com o CANAIS dele
+        ${HOST_DIR}/../interface.c
+        ${LIB_DIR}/scheduler.c
+        )
+target_compile_definitions(ohmimetro_replay PRIVATE CANAIS=${OHMIMETRO_CANAIS} PROF_ENABLED=1)
+target_compile_options(ohmimetro_replay PRIVATE -Wall -Wextra -Wno-unused-parameter)
+target_link_libraries(ohmimetro_replay ohmimetro_core)
+
+# Sessão sintética (ponta aberta, uma peça, um toque no botão A e a
+# retirada) para o teste replay, abaixo:
+#   ./replay_session > sessao.bin
+add_executable(replay_session ${HOST_DIR}/replay_session.c)
+target_compile_options(replay_session PRIVATE -Wall -Wextra -Wno-unused-parameter)
+target_link_libraries(replay_session ohmimetro_core)
+
+# Testes da lógica portátil: ctest --test-dir <build>
+enable_testing()
+foreach(teste adc_dma divider e_series robust_filter ssd1306)
+    add_executable(test_${teste} ${HOST_DIR}/test_${teste}.c)
+    target_compile_options(test_${teste} PRIVATE -Wall -Wextra -Wno-unused-parameter)
+    target_link_libraries(test_${teste} ohmimetro_core m)
+    add_test(NAME ${teste} COMMAND test_${teste})
+endforeach()
+
+# Seqlock com duas threads (escritor e leitor, como os dois cores), com o
+# seqlock recompilado sob o ThreadSanitizer quando o compilador suporta
+include(CheckCCompilerFlag)
+set(CMAKE_REQUIRED_FLAGS -fsanitize=thread)
+check_c_compiler_flag(-fsanitize=thread OHMIMETRO_HAS_TSAN)
+unset(CMAKE_REQUIRED_FLAGS)
+find_package(Threads REQUIRED)
+add_executable(test_seqlock ${HOST_DIR}/test_seqlock.c ${LIB_DIR}/seqlock.c)
+target_include_directories(test_seqlock PRIVATE ${LIB_DIR})
+target_compile_options(test_seqlock PRIVATE -Wall -Wextra)
+target_link_libraries(test_seqlock Threads::Threads)
+if (OHMIMETRO_HAS_TSAN)
+    target_compile_options(test_seqlock PRIVATE -fsanitize=thread -g)
+    target_link_options(test_seqlock PRIVATE -fsanitize=thread)
+endif()
+add_test(NAME seqlock COMMAND test_seqlock)
+
+# Enquadramento, codificação por deltas e contadores de descarte da
+# telemetria, de ponta a ponta pelo decodificador do host
+# Reprodução de ponta a ponta: filtro, decisão, modos e desenho da tela do
+# firmware sobre a sessão sintética
+add_test(NAME replay
+        COMMAND ${CMAKE_COMMAND} -DSESSION=$<TARGET_FILE:replay_session> -DREPLAY=$<TARGET_FILE:ohmimetro_replay>
+        -DCANAIS=${OHMIMETRO_CANAIS} -DWORK_DIR=${CMAKE_CURRENT_BINARY_DIR} -P ${HOST_DIR}/replay_check.cmake)
+
+add_test(NAME telemetry_loopback
+        COMMAND sh -c "\"$<TARGET_FILE:telemetry_loopback>\" | \"${Python3_EXECUTABLE}\" \"${HOST_DIR}/../tools/telemetry_decode.py\" --check-ramp -")
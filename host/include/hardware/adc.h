@@ -0,0 +1,28 @@
+#ifndef HOST_HARDWARE_ADC_H
+#define HOST_HARDWARE_ADC_H
+
+#include "pico/stdlib.h"
+
+// ADC do host: nada é convertido; as amostras chegam por host_adc_push(),
+// que faz o papel da FIFO em free-running, ou direto por adc_dma_deliver()
+typedef struct {
+    volatile uint32_t cs, result, fcs, fifo, div, intr, inte, intf, ints;
+} adc_hw_t;
+
+extern adc_hw_t host_adc_hw;
+#define adc_hw (&host_adc_hw)
+#define DREQ_ADC 36
+
+void adc_init(void);
+void adc_gpio_init(uint gpio);
+void adc_select_input(uint input);
+void adc_set_round_robin(uint input_mask);
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift);
+void adc_set_clkdiv(float clkdiv);
+void adc_fifo_drain(void);
+void adc_run(bool run);
+
+void host_adc_push(const uint16_t *samples, uint count);
+uint32_t host_adc_fifo_overflows(void);
+
+#endif
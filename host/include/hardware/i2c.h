@@ -0,0 +1,56 @@
+#ifndef HOST_HARDWARE_I2C_H
+#define HOST_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+// Registradores do DW_apb_i2c usados pelo driver do SSD1306. No host o
+// barramento está sempre ocioso: a transferência termina no próprio IRQ do DMA.
+// Os bytes escritos (por i2c_write_blocking ou pelo DMA com DREQ de TX do
+// I2C) são entregues, transação a transação, ao sink registrado com
+// host_i2c_set_sink(), como um dispositivo no barramento os veria.
+typedef struct {
+    volatile uint32_t con, tar, sar, _pad0, data_cmd;
+    volatile uint32_t ss_scl_hcnt, ss_scl_lcnt, fs_scl_hcnt, fs_scl_lcnt, _pad1[2];
+    volatile uint32_t intr_stat, intr_mask, raw_intr_stat, rx_tl, tx_tl;
+    volatile uint32_t clr_intr, clr_rx_under, clr_rx_over, clr_tx_over, clr_rd_req, clr_tx_abrt;
+    volatile uint32_t clr_rx_done, clr_activity, clr_stop_det, clr_start_det, clr_gen_call;
+    volatile uint32_t enable, status, txflr, rxflr, sda_hold, tx_abrt_source;
+    volatile uint32_t slv_data_nack_only, dma_cr, dma_tdlr, dma_rdlr;
+} i2c_hw_t;
+
+#define HOST_I2C_TRANSACTION_MAX 2048
+
+// Uma transação completa: endereço de 7 bits e os bytes do START ao STOP
+typedef void (*host_i2c_sink_t)(uint8_t addr, const uint8_t *data, size_t len);
+
+typedef struct i2c_inst {
+    i2c_hw_t hw;
+    uint32_t bytes_written; // Bytes recebidos por i2c_write_blocking
+    host_i2c_sink_t sink;
+    uint8_t pending[HOST_I2C_TRANSACTION_MAX]; // Transação ainda sem STOP
+    size_t pending_len;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst, i2c1_inst;
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+#define DREQ_I2C0_TX 32
+#define DREQ_I2C1_TX 34
+
+#define I2C_IC_DATA_CMD_STOP_BITS 0x200u
+#define I2C_IC_DMA_CR_TDMAE_BITS 0x2u
+#define I2C_IC_STATUS_ACTIVITY_BITS 0x1u
+#define I2C_IC_STATUS_TFE_BITS 0x4u
+#define I2C_IC_ENABLE_ENABLE_BITS 0x1u
+#define I2C_IC_INTR_MASK_M_STOP_DET_BITS 0x200u
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c);
+uint i2c_hw_index(i2c_inst_t *i2c);
+uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx);
+void host_i2c_set_sink(i2c_inst_t *i2c, host_i2c_sink_t sink);
+void host_i2c_write_word(i2c_inst_t *i2c, uint32_t data_cmd);
+
+#endif
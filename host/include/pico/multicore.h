@@ -0,0 +1,10 @@
+#ifndef HOST_PICO_MULTICORE_H
+#define HOST_PICO_MULTICORE_H
+
+// Um core só no host: quem chama decide quando o "core 1" roda
+void multicore_launch_core1(void (*entry)(void));
+void multicore_lockout_victim_init(void);
+void multicore_lockout_start_blocking(void);
+void multicore_lockout_end_blocking(void);
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef HOST_PICO_PLATFORM_H
+#define HOST_PICO_PLATFORM_H
+
+// Substituto do pico/platform.h: no host não há XIP, as funções marcadas para
+// a SRAM ficam onde o compilador as colocar.
+
+#define __not_in_flash_func(func_name) func_name
+#define __not_in_flash(group)
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+// Substituto mínimo do pico/stdlib.h para compilar a lógica portátil no host
+// (OHMIMETRO_HOST). Só declara o que lib/ e o firmware (na reprodução) usam;
+// as implementações ficam em host/pico_host.c.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pico/platform.h"
+#include "hardware/sync.h"
+
+typedef unsigned int uint;
+
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+void tight_loop_contents(void);
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+
+// Relógio virtual: a partir da primeira chamada o tempo só anda por aqui
+// (e por sleep_us), como na reprodução de uma gravação
+void host_clock_set_us(uint64_t us);
+
+// Alarmes: aceitos e nunca disparados (quem usa roda por sondagem no host)
+typedef int32_t alarm_id_t;
+typedef struct alarm_pool alarm_pool_t;
+typedef uint64_t absolute_time_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+
+static inline absolute_time_t from_us_since_boot(uint64_t us) {
+    return us;
+}
+
+alarm_pool_t *alarm_pool_get_default(void);
+alarm_pool_t *alarm_pool_create_with_unused_hardware_alarm(uint max_timers);
+alarm_id_t alarm_pool_add_alarm_at(alarm_pool_t *pool, absolute_time_t time, alarm_callback_t callback,
+                                   void *user_data, bool fire_if_past);
+bool alarm_pool_cancel_alarm(alarm_pool_t *pool, alarm_id_t alarm_id);
+
+// GPIO e stdio: sem efeito
+#define GPIO_IN false
+#define GPIO_OUT true
+#define GPIO_FUNC_I2C 3
+#define GPIO_FUNC_PWM 4
+#define GPIO_IRQ_EDGE_FALL 0x4u
+#define PICO_ERROR_TIMEOUT (-1)
+
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_pull_up(uint gpio);
+void gpio_set_function(uint gpio, uint fn);
+bool stdio_init_all(void);
+int getchar_timeout_us(uint32_t timeout_us);
+
+#endif
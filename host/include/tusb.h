@@ -0,0 +1,12 @@
+#ifndef HOST_TUSB_H
+#define HOST_TUSB_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// CDC do host: nunca conectado
+bool tud_cdc_connected(void);
+uint32_t tud_cdc_write(const void *buffer, uint32_t bufsize);
+uint32_t tud_cdc_write_flush(void);
+
+#endif
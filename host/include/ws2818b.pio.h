@@ -0,0 +1,14 @@
+#ifndef HOST_WS2818B_PIO_H
+#define HOST_WS2818B_PIO_H
+
+// No alvo este arquivo é gerado pelo pioasm a partir de lib/ws2818b.pio
+
+#include "hardware/pio.h"
+
+static const pio_program_t ws2818b_program = {0};
+
+static inline void ws2818b_program_init(PIO pio, uint sm, uint offset, uint pin, float freq) {
+    (void)pio; (void)sm; (void)offset; (void)pin; (void)freq;
+}
+
+#endif
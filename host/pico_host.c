@@ -0,0 +1,418 @@
+// Implementação dos substitutos do Pico SDK para o build no host
+#include <string.h>
+#include <time.h>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "pico/bootrom.h"
+#include "hardware/adc.h"
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/flash.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "tusb.h"
+
+#define HOST_IRQ_COUNT 32
+#define HOST_IRQ_HANDLERS 4
+#define HOST_DMA_CHANNELS 12
+
+i2c_inst_t i2c0_inst = {.hw = {.status = I2C_IC_STATUS_TFE_BITS}};
+i2c_inst_t i2c1_inst = {.hw = {.status = I2C_IC_STATUS_TFE_BITS}};
+pio_hw_t pio0_hw, pio1_hw;
+adc_hw_t host_adc_hw;
+uint8_t host_flash[PICO_FLASH_SIZE_BYTES];
+
+static irq_handler_t irq_handlers[HOST_IRQ_COUNT][HOST_IRQ_HANDLERS];
+static bool irq_enabled[HOST_IRQ_COUNT];
+static bool dma_irq1_enabled[HOST_DMA_CHANNELS];
+static bool dma_irq1_pending[HOST_DMA_CHANNELS];
+static int dma_next_channel = 0;
+
+// Canais que leem a FIFO do ADC: cada amostra de host_adc_push() vai para o
+// canal ocupado, que ao terminar sinaliza o IRQ 0 e dispara o encadeado.
+// Como no RP2040, TRANS_COUNT guarda o valor recarregado a cada disparo.
+typedef struct {
+    volatile uint16_t *write;
+    uint32_t reload, remaining;
+    uint chain_to, dreq, data_size;
+    bool busy, irq0_enabled, irq0_pending;
+} host_dma_channel_t;
+
+static host_dma_channel_t dma_channels[HOST_DMA_CHANNELS];
+static bool adc_running = false;
+static uint32_t adc_fifo_overflows = 0;
+
+static void host_dma_trigger(uint channel) {
+    dma_channels[channel].remaining = dma_channels[channel].reload;
+    dma_channels[channel].busy = true;
+}
+
+static bool clock_virtual = false;
+static uint64_t clock_virtual_us;
+
+uint64_t time_us_64(void) {
+    if (clock_virtual)
+        return clock_virtual_us;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000;
+}
+
+void host_clock_set_us(uint64_t us) {
+    clock_virtual = true;
+    clock_virtual_us = us;
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)time_us_64();
+}
+
+void tight_loop_contents(void) {
+}
+
+void sleep_us(uint64_t us) {
+    if (clock_virtual) {
+        clock_virtual_us += us;
+        return;
+    }
+    uint64_t end = time_us_64() + us;
+    while (time_us_64() < end)
+        ;
+}
+
+void sleep_ms(uint32_t ms) {
+    sleep_us((uint64_t)ms * 1000u);
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    (void)i2c;
+    return baudrate;
+}
+
+void host_i2c_set_sink(i2c_inst_t *i2c, host_i2c_sink_t sink) {
+    i2c->sink = sink;
+    i2c->pending_len = 0;
+}
+
+static void host_i2c_put(i2c_inst_t *i2c, uint8_t addr, uint8_t byte, bool stop) {
+    if (i2c->pending_len < HOST_I2C_TRANSACTION_MAX)
+        i2c->pending[i2c->pending_len++] = byte;
+    if (stop) {
+        if (i2c->sink)
+            i2c->sink(addr, i2c->pending, i2c->pending_len);
+        i2c->pending_len = 0;
+    }
+}
+
+// Escrita no IC_DATA_CMD: byte nos bits 7:0, STOP no bit 9, endereço no TAR
+void host_i2c_write_word(i2c_inst_t *i2c, uint32_t data_cmd) {
+    host_i2c_put(i2c, (uint8_t)i2c->hw.tar, (uint8_t)data_cmd, data_cmd & I2C_IC_DATA_CMD_STOP_BITS);
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    for (size_t i = 0; i < len; i++)
+        host_i2c_put(i2c, addr, src[i], !nostop && i + 1 == len);
+    i2c->bytes_written += len;
+    return (int)len;
+}
+
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {
+    return &i2c->hw;
+}
+
+uint i2c_hw_index(i2c_inst_t *i2c) {
+    return i2c == i2c1 ? 1 : 0;
+}
+
+uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) {
+    return (is_tx ? DREQ_I2C0_TX : DREQ_I2C0_TX + 1) + 2 * i2c_hw_index(i2c);
+}
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    irq_handlers[num][0] = handler;
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority) {
+    (void)order_priority;
+    for (int i = 0; i < HOST_IRQ_HANDLERS; i++) {
+        if (!irq_handlers[num][i]) {
+            irq_handlers[num][i] = handler;
+            return;
+        }
+    }
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    irq_enabled[num] = enabled;
+}
+
+static void host_irq_raise(uint num) {
+    if (!irq_enabled[num])
+        return;
+    for (int i = 0; i < HOST_IRQ_HANDLERS && irq_handlers[num][i]; i++)
+        irq_handlers[num][i]();
+}
+
+int dma_claim_unused_channel(bool required) {
+    (void)required;
+    return dma_next_channel < HOST_DMA_CHANNELS ? dma_next_channel++ : -1;
+}
+
+// Como no SDK, o canal encadeia nele mesmo (sem encadeamento) por padrão
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    dma_channel_config c = {.ctrl = DMA_SIZE_32 << 2, .chain_to = channel, .dreq = DREQ_FORCE};
+    return c;
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {
+    c->ctrl = (c->ctrl & ~0xcu) | ((uint32_t)size << 2);
+}
+
+void channel_config_set_read_increment(dma_channel_config *c, bool incr) {
+    (void)c; (void)incr;
+}
+
+void channel_config_set_write_increment(dma_channel_config *c, bool incr) {
+    (void)c; (void)incr;
+}
+
+void channel_config_set_dreq(dma_channel_config *c, uint dreq) {
+    c->dreq = dreq;
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger) {
+    (void)read_addr;
+    host_dma_channel_t *ch = &dma_channels[channel];
+    ch->write = write_addr;
+    ch->reload = transfer_count;
+    ch->chain_to = config->chain_to;
+    ch->dreq = config->dreq;
+    ch->data_size = (config->ctrl >> 2) & 0x3u;
+    ch->busy = false;
+    if (trigger)
+        host_dma_trigger(channel);
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count) {
+    host_dma_channel_t *ch = &dma_channels[channel];
+    if (ch->dreq == DREQ_I2C0_TX || ch->dreq == DREQ_I2C1_TX) {
+        i2c_inst_t *i2c = ch->dreq == DREQ_I2C0_TX ? i2c0 : i2c1;
+        for (uint32_t i = 0; i < transfer_count; i++) {
+            if (ch->data_size == DMA_SIZE_8)
+                host_i2c_write_word(i2c, ((const volatile uint8_t *)read_addr)[i]);
+            else if (ch->data_size == DMA_SIZE_16)
+                host_i2c_write_word(i2c, ((const volatile uint16_t *)read_addr)[i]);
+            else
+                host_i2c_write_word(i2c, ((const volatile uint32_t *)read_addr)[i]);
+        }
+    }
+    if (dma_irq1_enabled[channel]) {
+        dma_irq1_pending[channel] = true;
+        host_irq_raise(DMA_IRQ_1);
+    }
+}
+
+void dma_channel_set_irq1_enabled(uint channel, bool enabled) {
+    dma_irq1_enabled[channel] = enabled;
+}
+
+bool dma_channel_get_irq1_status(uint channel) {
+    return dma_irq1_pending[channel];
+}
+
+void dma_channel_acknowledge_irq1(uint channel) {
+    dma_irq1_pending[channel] = false;
+}
+
+uint pio_add_program(PIO pio, const pio_program_t *program) {
+    (void)pio; (void)program;
+    return 0;
+}
+
+int pio_claim_unused_sm(PIO pio, bool required) {
+    (void)pio; (void)required;
+    return 0;
+}
+
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx) {
+    (void)pio; (void)sm; (void)is_tx;
+    return 0;
+}
+
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger) {
+    dma_channels[channel].write = write_addr;
+    if (trigger)
+        host_dma_trigger(channel);
+}
+
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger) {
+    dma_channels[channel].reload = trans_count;
+    if (trigger)
+        host_dma_trigger(channel);
+}
+
+void channel_config_set_chain_to(dma_channel_config *c, uint chain_to) {
+    c->chain_to = chain_to;
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled) {
+    dma_channels[channel].irq0_enabled = enabled;
+}
+
+bool dma_channel_get_irq0_status(uint channel) {
+    return dma_channels[channel].irq0_pending;
+}
+
+void dma_channel_acknowledge_irq0(uint channel) {
+    dma_channels[channel].irq0_pending = false;
+}
+
+void dma_channel_abort(uint channel) {
+    dma_channels[channel].busy = false;
+}
+
+// Alarmes nunca disparam: o escalonador do host roda por sondagem
+alarm_pool_t *alarm_pool_get_default(void) {
+    return NULL;
+}
+
+alarm_pool_t *alarm_pool_create_with_unused_hardware_alarm(uint max_timers) {
+    (void)max_timers;
+    return NULL;
+}
+
+alarm_id_t alarm_pool_add_alarm_at(alarm_pool_t *pool, absolute_time_t time, alarm_callback_t callback,
+                                   void *user_data, bool fire_if_past) {
+    (void)pool; (void)time; (void)callback; (void)user_data; (void)fire_if_past;
+    return 1;
+}
+
+bool alarm_pool_cancel_alarm(alarm_pool_t *pool, alarm_id_t alarm_id) {
+    (void)pool; (void)alarm_id;
+    return true;
+}
+
+void gpio_init(uint gpio) {
+    (void)gpio;
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+    (void)gpio; (void)out;
+}
+
+void gpio_pull_up(uint gpio) {
+    (void)gpio;
+}
+
+void gpio_set_function(uint gpio, uint fn) {
+    (void)gpio; (void)fn;
+}
+
+bool stdio_init_all(void) {
+    return true;
+}
+
+int getchar_timeout_us(uint32_t timeout_us) {
+    (void)timeout_us;
+    return PICO_ERROR_TIMEOUT;
+}
+
+void adc_init(void) {
+}
+
+void adc_gpio_init(uint gpio) {
+    (void)gpio;
+}
+
+void adc_select_input(uint input) {
+    (void)input;
+}
+
+void adc_set_round_robin(uint input_mask) {
+    (void)input_mask;
+}
+
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift) {
+    (void)en; (void)dreq_en; (void)dreq_thresh; (void)err_in_fifo; (void)byte_shift;
+}
+
+void adc_set_clkdiv(float clkdiv) {
+    (void)clkdiv;
+}
+
+void adc_fifo_drain(void) {
+}
+
+void adc_run(bool run) {
+    adc_running = run;
+}
+
+// Conversões do ADC em free-running: cada amostra vai para o canal de DMA
+// ocupado com DREQ_ADC; sem nenhum (o IRQ não rearmou a tempo) ela se perde,
+// como na FIFO cheia do alvo
+void host_adc_push(const uint16_t *samples, uint count) {
+    for (uint i = 0; i < count && adc_running; i++) {
+        host_dma_channel_t *ch = NULL;
+        for (int c = 0; c < dma_next_channel && !ch; c++) {
+            if (dma_channels[c].busy && dma_channels[c].dreq == DREQ_ADC)
+                ch = &dma_channels[c];
+        }
+        if (!ch) {
+            adc_fifo_overflows++;
+            continue;
+        }
+        *ch->write++ = samples[i];
+        if (--ch->remaining)
+            continue;
+        ch->busy = false;
+        if (ch->chain_to != (uint)(ch - dma_channels))
+            host_dma_trigger(ch->chain_to);
+        if (ch->irq0_enabled) {
+            ch->irq0_pending = true;
+            host_irq_raise(DMA_IRQ_0);
+        }
+    }
+}
+
+uint32_t host_adc_fifo_overflows(void) {
+    return adc_fifo_overflows;
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    memset(&host_flash[flash_offs], 0xFF, count);
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+    memcpy(&host_flash[flash_offs], data, count);
+}
+
+void multicore_launch_core1(void (*entry)(void)) {
+    (void)entry;
+}
+
+void multicore_lockout_victim_init(void) {
+}
+
+void multicore_lockout_start_blocking(void) {
+}
+
+void multicore_lockout_end_blocking(void) {
+}
+
+void reset_usb_boot(uint32_t gpio_activity_pin_mask, uint32_t disable_interface_mask) {
+    (void)gpio_activity_pin_mask; (void)disable_interface_mask;
+}
+
+bool tud_cdc_connected(void) {
+    return false;
+}
+
+uint32_t tud_cdc_write(const void *buffer, uint32_t bufsize) {
+    (void)buffer;
+    return bufsize;
+}
+
+uint32_t tud_cdc_write_flush(void) {
+    return 0;
+}
@@ -0,0 +1,507 @@
+// Reprodução de uma sessão gravada ('g' no console) pelo código do firmware
+//
+// Os módulos do firmware são ligados aqui como estão: lib/meter.c (filtro,
+// conversão e busca do valor comercial) e interface.c (cores, desenho da
+// tela e matriz de LEDs) são os mesmos do alvo. O ADC vira a
+// gravação (cada TELEMETRY_BLOCK é entregue por adc_dma_deliver, como o IRQ
+// do DMA faria), o relógio é virtual (o instante gravado de cada bloco e de
+// cada toque) e o I2C só conta bytes. Depois de cada bloco rodam as tarefas
+// do core 1 e as do core 0, nessa ordem.
+//
+// Na saída padrão, uma linha CSV por canal a cada quadro enviado ao display
+// (o que a tela decidiu mostrar e o CRC do framebuffer); no stderr, as
+// mensagens do firmware, o resumo da sessão, a comparação com as leituras
+// gravadas e o tempo de CPU por
+// etapa (PROF_*) em ns do host. No host o envio ao display é instantâneo: a
+// etapa i2c usa o tempo de barramento estimado a 400 kHz (9 bits por byte).
+//
+// Uso: ohmimetro_replay sessao.bin [--pbm prefixo] > quadros.csv
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../interface.h"
+#include "adc_cal.h"
+#include "buzzer.h"
+#include "led_anim.h"
+#include "probe.h"
+#include "prof.h"
+#include "ws2818b.h"
+
+#define I2C_NS_POR_BYTE 22500u // 9 bits a 400 kHz
+#define R_CONHECIDO_PADRAO 10000 // Até o cabeçalho da sessão trazer a calibração
+
+static ssd1306_t ssd;
+static scheduler_t sched_core0, sched_core1;
+static adc_cal_t calibracao;
+static uint16_t tabela_correcao_q4[ADC_CAL_CODES];
+static FILE *csv; // A saída padrão original; o printf do firmware vai para o stderr
+
+// ---------------------------------------------------------------------------
+// Substitutos do que o firmware usa e o host não tem
+// ---------------------------------------------------------------------------
+
+static uint32_t bipes;
+static bool bipe_ligado;
+
+void led_anim_stop(void) {
+}
+
+bool led_anim_running(void) {
+    return false;
+}
+
+void buzzer_set(bool on) {
+    if (on && !bipe_ligado)
+        bipes++;
+    bipe_ligado = on;
+}
+
+// Etapas em ns do host: prof_now conta para baixo como o SysTick, então as
+// macros do firmware não mudam (e a máscara de 24 bits limita cada medida a
+// ~16 ms, folga de sobra no host)
+typedef struct {
+    uint32_t *ns;
+    uint32_t count, capacity;
+} etapa_t;
+
+static etapa_t etapas[PROF_STAGE_COUNT];
+
+static const char *const nomes_etapas[PROF_STAGE_COUNT] = {
+    "aquisicao", "conversao", "busca", "render", "i2c", "leds",
+};
+
+void prof_init_core(void) {
+}
+
+uint32_t prof_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return -(uint32_t)((uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+
+void prof_record(prof_stage_t stage, uint32_t ns) {
+    etapa_t *e = &etapas[stage];
+    if (e->count == e->capacity) {
+        e->capacity = e->capacity ? e->capacity * 2 : 1024;
+        e->ns = realloc(e->ns, e->capacity * sizeof(uint32_t));
+        if (!e->ns) {
+            fprintf(stderr, "replay: sem memoria\n");
+            exit(1);
+        }
+    }
+    e->ns[e->count++] = ns;
+}
+
+// Só a etapa i2c usa: o envio foi instantâneo, vale o barramento estimado
+void prof_record_us(prof_stage_t stage, uint32_t us) {
+    prof_record(stage, stage == PROF_I2C_FLUSH ? ssd.flush_bytes * I2C_NS_POR_BYTE : us * 1000u);
+}
+
+void prof_reset(void) {
+    for (int i = 0; i < PROF_STAGE_COUNT; i++)
+        etapas[i].count = 0;
+}
+
+static int compara_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// CSV em ns: etapa,n,min,media,p99,max (p99 de todas as medidas)
+void prof_dump_csv(void) {
+    fprintf(stderr, "etapa,n,min_ns,media_ns,p99_ns,max_ns\n");
+    for (int i = 0; i < PROF_STAGE_COUNT; i++) {
+        etapa_t *e = &etapas[i];
+        if (e->count == 0) {
+            fprintf(stderr, "%s,0,0,0,0,0\n", nomes_etapas[i]);
+            continue;
+        }
+        qsort(e->ns, e->count, sizeof(uint32_t), compara_u32);
+        uint64_t soma = 0;
+        for (uint32_t k = 0; k < e->count; k++)
+            soma += e->ns[k];
+        fprintf(stderr, "%s,%lu,%lu,%lu,%lu,%lu\n", nomes_etapas[i], (unsigned long)e->count,
+                (unsigned long)e->ns[0], (unsigned long)(soma / e->count),
+                (unsigned long)e->ns[(e->count * 99 + 99) / 100 - 1], (unsigned long)e->ns[e->count - 1]);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Leitura da gravação
+// ---------------------------------------------------------------------------
+
+static uint32_t le_u16(const uint8_t *p) {
+    return p[0] | (uint32_t)p[1] << 8;
+}
+
+static uint32_t le_u32(const uint8_t *p) {
+    return le_u16(p) | le_u16(p + 2) << 16;
+}
+
+static uint16_t fletcher16(const uint8_t *p, uint32_t n) {
+    uint32_t sum1 = 0, sum2 = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        sum1 = (sum1 + p[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    return (uint16_t)(sum2 << 8 | sum1);
+}
+
+static uint8_t *carrega_arquivo(const char *caminho, size_t *tamanho) {
+    FILE *f = strcmp(caminho, "-") == 0 ? stdin : fopen(caminho, "rb");
+    if (!f) {
+        perror(caminho);
+        exit(1);
+    }
+    size_t capacidade = 1 << 20, n = 0, lidos;
+    uint8_t *dados = malloc(capacidade);
+    while (dados && (lidos = fread(dados + n, 1, capacidade - n, f)) > 0) {
+        n += lidos;
+        if (n == capacidade)
+            dados = realloc(dados, capacidade *= 2);
+    }
+    if (!dados) {
+        fprintf(stderr, "replay: sem memoria\n");
+        exit(1);
+    }
+    if (f != stdin)
+        fclose(f);
+    *tamanho = n;
+    return dados;
+}
+
+// ---------------------------------------------------------------------------
+// Reprodução
+// ---------------------------------------------------------------------------
+
+// Leituras gravadas ainda não comparadas, por canal
+#define FILA_LEITURAS 256
+typedef struct {
+    telemetry_reading_t itens[FILA_LEITURAS];
+    uint32_t inicio, fim;
+} fila_t;
+
+static struct {
+    bool sessao;
+    bool tabela_pendente;  // CAL chegou: refaz a tabela antes do próximo bloco
+    uint32_t proximo_bloco;
+    uint32_t blocos, lacunas, blocos_perdidos;
+    uint32_t pacotes, invalidos, bytes_descartados, sequencia_perdida;
+    uint16_t seq;
+    bool seq_valida;
+    uint64_t tempo_base;   // Extensão do tempo de 32 bits
+    uint32_t tempo_anterior;
+    fila_t gravadas[CANAIS];
+    uint32_t versao[CANAIS];
+    uint32_t comparadas, iguais, sem_par;
+    bool divergiu;
+    uint32_t quadros, bytes_i2c, ultimo_quadro;
+    const char *prefixo_pbm;
+} rep;
+
+static uint64_t tempo_64(uint32_t t) {
+    if (t < rep.tempo_anterior)
+        rep.tempo_base += 1ull << 32;
+    rep.tempo_anterior = t;
+    return rep.tempo_base + t;
+}
+
+static void aplica_sessao(const uint8_t *p, uint32_t len) {
+    if (len < TELEMETRY_SESSION_BYTES || p[0] != TELEMETRY_SESSION_VERSION) {
+        fprintf(stderr, "replay: sessao de versao %u nao suportada\n", len ? p[0] : 0);
+        exit(1);
+    }
+    if (p[1] != CANAIS) {
+        fprintf(stderr, "replay: gravacao com %u canais; compile com -DOHMIMETRO_CANAIS=%u\n", p[1], p[1]);
+        exit(1);
+    }
+    meter_set_series(p[3]);
+    interface_define_modo(p[4] < MODO_COUNT ? p[4] : MODO_SIMPLES);
+    for (int c = 0; c < ADC_CAL_CHANNELS; c++)
+        calibracao.r_known_mohm[c] = le_u32(p + 13 + 4 * c);
+    calibracao.offset_q4 = (int32_t)le_u32(p + 25);
+    calibracao.lin_first = le_u16(p + 29);
+    calibracao.lin_last = le_u16(p + 31);
+    adc_cal_build_table(&calibracao, tabela_correcao_q4);
+
+    // O firmware reinicia os canais no início da gravação
+    meter_restart(p[2], le_u32(p + 9));
+    rep.proximo_bloco = meter_blocks();
+    rep.sessao = true;
+    fprintf(stderr, "# sessao: %u canal(is), %lu Hz, serie %u, modo %u, bloco %lu\n", p[1],
+            (unsigned long)le_u32(p + 5), p[3], p[4], (unsigned long)meter_blocks());
+}
+
+static void aplica_cal(const uint8_t *p, uint32_t len) {
+    uint32_t primeiro = le_u16(p), n = le_u16(p + 2);
+    if (len < 4 + 2 * n || primeiro + n > ADC_CAL_CODES)
+        return;
+    for (uint32_t i = 0; i < n; i++)
+        calibracao.center_q4[primeiro + i] = le_u16(p + 4 + 2 * i);
+    rep.tabela_pendente = true;
+}
+
+static void aplica_toque(const uint8_t *p) {
+    uint64_t t = tempo_64(le_u32(p + 4));
+    host_clock_set_us(t);
+    uint8_t tipo = p[8], valor = p[9];
+    if (tipo == TELEMETRY_EVENT_BUTTON_A)
+        botao_a_handler(0, GPIO_IRQ_EDGE_FALL, t);
+    else if (tipo == TELEMETRY_EVENT_BUTTON_JOY)
+        botao_joy_handler(0, GPIO_IRQ_EDGE_FALL, t);
+    uint8_t obtido = tipo == TELEMETRY_EVENT_BUTTON_A ? interface_modo() : meter_series();
+    if (obtido != valor)
+        fprintf(stderr, "# toque %u no bloco %lu: firmware foi para %u, gravado %u\n", tipo,
+                (unsigned long)le_u32(p), obtido, valor);
+}
+
+static void guarda_leitura(const uint8_t *p, uint32_t len) {
+    if (len < TELEMETRY_READING_BYTES || !rep.sessao)
+        return;
+    telemetry_reading_t r = {
+        .r_x_mohm = le_u32(p),
+        .closest_mohm = le_u32(p + 4),
+        .incerteza_mohm = le_u32(p + 8),
+        .media_q8 = le_u32(p + 12),
+        .amostras = le_u32(p + 16),
+        .estado = p[28],
+        .series = p[29],
+        .canal = p[30],
+    };
+    if (r.canal >= CANAIS)
+        return;
+    fila_t *f = &rep.gravadas[r.canal];
+    if (f->fim - f->inicio == FILA_LEITURAS) {
+        f->inicio++; // A reprodução ficou muito para trás: a mais antiga fica sem par
+        rep.sem_par++;
+    }
+    f->itens[f->fim++ % FILA_LEITURAS] = r;
+}
+
+// Leituras publicadas pelo core 1 neste bloco contra as gravadas
+static void compara_leituras(void) {
+    for (int c = 0; c < CANAIS; c++) {
+        if (meter_version(c) == rep.versao[c])
+            continue;
+        meter_reading_t leitura;
+        rep.versao[c] = meter_read(c, &leitura);
+        fila_t *f = &rep.gravadas[c];
+        if (f->inicio == f->fim) {
+            rep.sem_par++;
+            continue;
+        }
+        const telemetry_reading_t *g = &f->itens[f->inicio++ % FILA_LEITURAS];
+        rep.comparadas++;
+        if (g->estado == leitura.estado && g->closest_mohm == leitura.closest_mohm &&
+            g->r_x_mohm == leitura.r_x_mohm) {
+            rep.iguais++;
+        } else if (!rep.divergiu) {
+            rep.divergiu = true;
+            fprintf(stderr, "# primeira divergencia no bloco %lu, canal %d: gravado estado %u r_x %lu comercial %lu,"
+                    " reproduzido estado %u r_x %lu comercial %lu\n", (unsigned long)meter_blocks(), c,
+                    g->estado, (unsigned long)g->r_x_mohm, (unsigned long)g->closest_mohm, leitura.estado,
+                    (unsigned long)leitura.r_x_mohm, (unsigned long)leitura.closest_mohm);
+        }
+    }
+}
+
+static uint32_t crc_tela(void) {
+    uint32_t h = 2166136261u; // FNV-1a
+    for (size_t i = 0; i < ssd.bufsize; i++)
+        h = (h ^ ssd.ram_buffer[i]) * 16777619u;
+    return h;
+}
+
+// Framebuffer como imagem PBM (páginas verticais de 8 pixels)
+static void grava_pbm(void) {
+    char caminho[512];
+    snprintf(caminho, sizeof(caminho), "%s%05lu.pbm", rep.prefixo_pbm, (unsigned long)rep.quadros);
+    FILE *f = fopen(caminho, "w");
+    if (!f) {
+        perror(caminho);
+        exit(1);
+    }
+    fprintf(f, "P1\n%u %u\n", ssd.width, ssd.height);
+    for (uint8_t y = 0; y < ssd.height; y++) {
+        for (uint8_t x = 0; x < ssd.width; x++)
+            fputc(ssd.ram_buffer[1 + (y >> 3) + x * ssd.pages] >> (y & 7) & 1 ? '1' : '0', f);
+        fputc('\n', f);
+    }
+    fclose(f);
+}
+
+// Um quadro enviado: o que cada canal mostra
+static void registra_quadro(void) {
+    rep.quadros++;
+    rep.bytes_i2c += ssd.flush_bytes;
+    uint32_t crc = crc_tela();
+    uint8_t modo = interface_modo();
+    for (int c = 0; c < (modo == MODO_CANAIS ? CANAIS : 1); c++) {
+        const meter_reading_t *l = &interface_leituras()[c];
+        char faixas[16] = "";
+        if ((l->estado == PROBE_STABLE || l->estado == PROBE_HOLD) && l->digits) {
+            int n = 0;
+            for (int i = 0; i < l->digits; i++)
+                n += snprintf(faixas + n, sizeof(faixas) - n, "%u-", l->bands[i]);
+            snprintf(faixas + n, sizeof(faixas) - n, "%u", l->multiplier);
+        }
+        fprintf(csv, "%.3f,%lu,%u,%d,%u,%lu,%lu,%s,%lu,%08lx\n", time_us_64() / 1000.0,
+                (unsigned long)meter_blocks(), modo, c, l->estado, (unsigned long)l->r_x_mohm, (unsigned long)l->closest_mohm, faixas,
+               (unsigned long)ssd.flush_bytes, (unsigned long)crc);
+    }
+    if (rep.prefixo_pbm)
+        grava_pbm();
+}
+
+static void reproduz_bloco(const uint8_t *p, uint32_t len) {
+    uint16_t amostras[ADC_DMA_BLOCK_SAMPLES];
+    uint32_t bloco, tempo;
+    uint32_t n = telemetry_unpack_block(p, len, &bloco, &tempo, amostras, ADC_DMA_BLOCK_SAMPLES);
+    if (n == 0 || !rep.sessao) {
+        rep.invalidos += n == 0;
+        return;
+    }
+    if (rep.tabela_pendente) {
+        adc_cal_build_table(&calibracao, tabela_correcao_q4);
+        rep.tabela_pendente = false;
+    }
+    if (bloco != rep.proximo_bloco) {
+        // Bloco perdido no anel: a fase da varredura segue o que o firmware viu
+        rep.lacunas++;
+        rep.blocos_perdidos += bloco - rep.proximo_bloco;
+        meter_skip(bloco - rep.proximo_bloco, n);
+    }
+    rep.proximo_bloco = bloco + 1;
+    rep.blocos++;
+
+    host_clock_set_us(tempo_64(tempo));
+    adc_dma_deliver(amostras, n); // Como o IRQ do DMA: chama o callback de lib/meter.c
+    sched_run_once(&sched_core1);
+    compara_leituras();
+    sched_run_once(&sched_core0);
+    if (ssd.frames_sent != rep.ultimo_quadro) {
+        rep.ultimo_quadro = ssd.frames_sent;
+        registra_quadro();
+    }
+}
+
+static void reproduz(const uint8_t *dados, size_t tamanho) {
+    size_t i = 0;
+    while (i + TELEMETRY_HEADER_BYTES + TELEMETRY_TRAILER_BYTES <= tamanho) {
+        if (dados[i] != TELEMETRY_SYNC0 || dados[i + 1] != TELEMETRY_SYNC1) {
+            i++;
+            rep.bytes_descartados++;
+            continue;
+        }
+        uint32_t len = le_u16(dados + i + 5);
+        size_t total = TELEMETRY_HEADER_BYTES + len + TELEMETRY_TRAILER_BYTES;
+        if (i + total > tamanho)
+            break;
+        if (fletcher16(dados + i + 2, TELEMETRY_HEADER_BYTES - 2 + len) !=
+            le_u16(dados + i + TELEMETRY_HEADER_BYTES + len)) {
+            i++; // Sincronismo falso: procura o próximo
+            rep.bytes_descartados++;
+            continue;
+        }
+        uint16_t seq = le_u16(dados + i + 3);
+        if (rep.seq_valida)
+            rep.sequencia_perdida += (uint16_t)(seq - rep.seq - 1);
+        rep.seq = seq;
+        rep.seq_valida = true;
+        rep.pacotes++;
+
+        const uint8_t *p = dados + i + TELEMETRY_HEADER_BYTES;
+        switch (dados[i + 2]) {
+        case TELEMETRY_SESSION:
+            aplica_sessao(p, len);
+            break;
+        case TELEMETRY_CAL:
+            aplica_cal(p, len);
+            break;
+        case TELEMETRY_EVENT:
+            if (len >= TELEMETRY_EVENT_BYTES && rep.sessao)
+                aplica_toque(p);
+            break;
+        case TELEMETRY_BLOCK:
+            reproduz_bloco(p, len);
+            break;
+        case TELEMETRY_READING:
+            guarda_leitura(p, len);
+            break;
+        default:
+            break; // TELEMETRY_SAMPLES e tipos novos não entram na reprodução
+        }
+        i += total;
+    }
+}
+
+// Mesma inicialização do main() do firmware, sem o hardware
+static void inicia_firmware(void) {
+    init_leds();
+    i2c_init(i2c1, 400 * 1000);
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, i2c1);
+    ssd1306_config(&ssd);
+    ssd1306_send_data(&ssd);
+    rep.ultimo_quadro = ssd.frames_sent;
+    adc_cal_defaults(&calibracao, R_CONHECIDO_PADRAO * 1000u);
+    adc_cal_build_table(&calibracao, tabela_correcao_q4);
+    meter_init(&calibracao, tabela_correcao_q4);
+
+    sched_init(&sched_core1, NULL);
+    meter_start(&sched_core1);
+    sched_init(&sched_core0, NULL);
+    interface_inicia(&sched_core0, &ssd);
+    prof_reset(); // A inicialização não entra nas etapas
+}
+
+int main(int argc, char **argv) {
+    const char *arquivo = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--pbm") == 0 && i + 1 < argc)
+            rep.prefixo_pbm = argv[++i];
+        else if (!arquivo)
+            arquivo = argv[i];
+    }
+    if (!arquivo) {
+        fprintf(stderr, "uso: %s sessao.bin [--pbm prefixo] > quadros.csv\n", argv[0]);
+        return 2;
+    }
+    size_t tamanho;
+    uint8_t *dados = carrega_arquivo(arquivo, &tamanho);
+
+    // O CSV fica com a saída padrão; a do firmware passa a ser o stderr
+    csv = fdopen(dup(STDOUT_FILENO), "w");
+    if (!csv || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+        perror("replay");
+        return 1;
+    }
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    host_clock_set_us(0);
+    inicia_firmware();
+    fprintf(csv, "tempo_ms,bloco,modo,canal,estado,r_x_mohm,comercial_mohm,faixas,bytes_i2c,crc_tela\n");
+    reproduz(dados, tamanho);
+    free(dados);
+
+    if (!rep.sessao) {
+        fprintf(stderr, "replay: nenhuma sessao em %s (a gravacao comeca com 'g')\n", arquivo);
+        return 1;
+    }
+    uint32_t pendentes = 0;
+    for (int c = 0; c < CANAIS; c++)
+        pendentes += rep.gravadas[c].fim - rep.gravadas[c].inicio;
+    fprintf(stderr, "# pacotes %lu, perdidos %lu, invalidos %lu, bytes descartados %lu\n", (unsigned long)rep.pacotes,
+            (unsigned long)rep.sequencia_perdida, (unsigned long)rep.invalidos, (unsigned long)rep.bytes_descartados);
+    fprintf(stderr, "# blocos %lu, lacunas %lu (%lu blocos)\n", (unsigned long)rep.blocos, (unsigned long)rep.lacunas,
+            (unsigned long)rep.blocos_perdidos);
+    fprintf(stderr, "# leituras: %lu comparadas, %lu iguais, %lu sem par\n", (unsigned long)rep.comparadas,
+            (unsigned long)rep.iguais, (unsigned long)(rep.sem_par + pendentes));
+    fprintf(stderr, "# quadros %lu, %lu bytes no I2C (~%lu ms de barramento), bipes %lu\n", (unsigned long)rep.quadros,
+            (unsigned long)rep.bytes_i2c, (unsigned long)((uint64_t)rep.bytes_i2c * I2C_NS_POR_BYTE / 1000000u),
+            (unsigned long)bipes);
+    prof_dump_csv();
+    return rep.divergiu ? 3 : 0;
+}
@@ -0,0 +1,47 @@
+# Teste de regressão da reprodução (ctest replay): gera a sessão sintética
+# de host/replay_session.c, roda o ohmimetro_replay sobre ela e confere o
+# código de saída e alguns quadros esperados do CSV.
+#
+#   cmake -DSESSION=<replay_session> -DREPLAY=<ohmimetro_replay> -DCANAIS=<n>
+#         -DWORK_DIR=<dir> -P replay_check.cmake
+
+set(SESSION_BIN ${WORK_DIR}/replay_session.bin)
+set(FRAMES_CSV ${WORK_DIR}/replay_frames.csv)
+
+execute_process(COMMAND ${SESSION} ${CANAIS} OUTPUT_FILE ${SESSION_BIN} RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "replay_session falhou (${result})")
+endif()
+execute_process(COMMAND ${REPLAY} ${SESSION_BIN} OUTPUT_FILE ${FRAMES_CSV} ERROR_VARIABLE log
+        RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "ohmimetro_replay saiu com ${result}:\n${log}")
+endif()
+
+# tempo_ms,bloco,modo,canal,estado,r_x_mohm,comercial_mohm,faixas,bytes_i2c,crc_tela
+# (estado: 0 = aberta, 3 = estável, 4 = HOLD; modo: 0 = simples, 1 = avançado)
+set(expected
+        "^[0-9.]+,[0-9]+,0,0,0,0,0,,"                  # Ponta aberta desde o boot: a tela já mostra
+        "^[0-9.]+,[0-9]+,0,0,3,[0-9]+,4700000,4-7-2,"  # 4,7k decidido (amarelo, violeta, vermelho)
+        "^[0-9.]+,[0-9]+,1,0,3,[0-9]+,4700000,4-7-2,"  # Botão A: modo avançado, mesma peça
+        "^[0-9.]+,[0-9]+,1,0,4,[0-9]+,4700000,4-7-2,"  # Retirada: leitura congelada
+        )
+# Com a ponta aberta no boot a primeira leitura já conta: sai antes da
+# peça (200 ms), não na primeira leitura estável dela
+if (NOT log MATCHES "Boot: primeira leitura em [1-9][0-9]?[0-9]?[0-9]?[0-9]? us")
+    message(FATAL_ERROR "tempo ate a primeira leitura nao informado:\n${log}")
+endif()
+
+file(STRINGS ${FRAMES_CSV} frames)
+foreach(pattern ${expected})
+    set(found FALSE)
+    foreach(frame ${frames})
+        if (frame MATCHES "${pattern}")
+            set(found TRUE)
+            break()
+        endif()
+    endforeach()
+    if (NOT found)
+        message(FATAL_ERROR "nenhum quadro casa com ${pattern} em ${FRAMES_CSV}")
+    endif()
+endforeach()
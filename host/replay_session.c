@@ -0,0 +1,100 @@
+// Sessão gravada sintética para o ohmimetro_replay: o mesmo enquadramento
+// do firmware (lib/telemetry) com a ponta aberta no boot, uma peça de 4,7k
+// no divisor de 10k, um toque no botão A (modo avançado) com a peça ainda
+// na ponta e a retirada (HOLD). Todos os canais da varredura veem o mesmo
+// nível, com um pouco de ruído.
+//
+// Uso: replay_session [canais] > sessao.bin
+//      ohmimetro_replay sessao.bin > quadros.csv
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "adc_cal.h"
+#include "e_series.h"
+#include "telemetry.h"
+
+#define BLOCK_SAMPLES 256
+#define CHANNEL_RATE_HZ 200000u // METER_CHANNEL_RATE_HZ
+#define R_KNOWN_MOHM 10000000u
+#define R_PART_MOHM 4700000u
+#define FIRST_BLOCK 10     // A gravação começa com o firmware já rodando
+// Fases em ms (a duração de um bloco depende do número de canais), todas
+// acima do período da tela
+#define OPEN_MS 200        // Ponta aberta desde o boot
+#define PART_MS 600        // Peça na ponta...
+#define BUTTON_MS 400      // ...com um toque no botão A no meio
+#define HOLD_MS 200        // Retirada: a última leitura fica congelada
+
+static telemetry_t ring;
+static uint32_t lcg = 1;
+
+static void drain(void) {
+    const uint8_t *data;
+    uint32_t n;
+    while ((n = telemetry_peek(&ring, &data)) > 0) {
+        fwrite(data, 1, n, stdout);
+        telemetry_consume(&ring, n);
+    }
+}
+
+// Código do divisor (R_x embaixo) com ±4 códigos de ruído
+static uint16_t sample(uint32_t r_mohm) {
+    uint32_t code = r_mohm ? (uint64_t)4095 * r_mohm / (r_mohm + R_KNOWN_MOHM) : 4095;
+    lcg = lcg * 1103515245u + 12345u;
+    int32_t s = (int32_t)code + (int32_t)((lcg >> 16) % 9) - 4;
+    return s < 0 ? 0 : s > 4095 ? 4095 : s;
+}
+
+int main(int argc, char **argv) {
+    uint8_t channels = argc > 1 ? (uint8_t)strtoul(argv[1], NULL, 0) : 1;
+    if (channels < 1 || channels > TELEMETRY_CHANNELS) {
+        fprintf(stderr, "replay_session: 1 a %d canais\n", TELEMETRY_CHANNELS);
+        return 2;
+    }
+    uint32_t rate_hz = CHANNEL_RATE_HZ * channels;
+    telemetry_init(&ring);
+
+    adc_cal_t cal;
+    adc_cal_defaults(&cal, R_KNOWN_MOHM);
+    telemetry_session_t s = {
+        .version = TELEMETRY_SESSION_VERSION,
+        .channels = channels,
+        .series = E_SERIES_E24,
+        .rate_hz = rate_hz,
+        .block = FIRST_BLOCK,
+        .offset_q4 = cal.offset_q4,
+        .lin_first = cal.lin_first,
+        .lin_last = cal.lin_last,
+    };
+    for (int c = 0; c < TELEMETRY_CHANNELS; c++)
+        s.r_known_mohm[c] = cal.r_known_mohm[c];
+    telemetry_put_session(&ring, &s);
+    drain();
+    for (uint16_t c = 0; c < ADC_CAL_CODES; c += TELEMETRY_CAL_CHUNK) {
+        telemetry_put_cal(&ring, c, &cal.center_q4[c], TELEMETRY_CAL_CHUNK);
+        drain();
+    }
+
+    uint16_t samples[BLOCK_SAMPLES];
+    uint32_t blocks_per_s = rate_hz / BLOCK_SAMPLES;
+    uint32_t part_start = OPEN_MS * blocks_per_s / 1000, part_end = part_start + PART_MS * blocks_per_s / 1000;
+    uint32_t button = part_start + BUTTON_MS * blocks_per_s / 1000;
+    uint32_t end = part_end + HOLD_MS * blocks_per_s / 1000;
+    for (uint32_t b = 0; b < end; b++) {
+        uint32_t block = FIRST_BLOCK + b;
+        uint32_t time_us = (uint64_t)block * BLOCK_SAMPLES * 1000000u / rate_hz;
+        bool part = b >= part_start && b < part_end;
+        for (uint32_t i = 0; i < BLOCK_SAMPLES; i++)
+            samples[i] = sample(part ? R_PART_MOHM : 0);
+        if (b == button) {
+            telemetry_event_t e = {block, time_us, TELEMETRY_EVENT_BUTTON_A, 1}; // Simples -> avançado
+            telemetry_put_event(&ring, &e);
+        }
+        telemetry_put_block(&ring, block, time_us, samples, BLOCK_SAMPLES);
+        drain();
+    }
+
+    fprintf(stderr, "blocos %lu, pacotes %lu, descartados %lu\n", (unsigned long)end, (unsigned long)ring.packets,
+            (unsigned long)ring.dropped_packets);
+    return ring.dropped_packets ? 1 : 0;
+}
@@ -0,0 +1,81 @@
+// Loopback da telemetria no host: produz blocos com uma rampa conhecida pelo
+// mesmo código do firmware (lib/telemetry), esvazia o anel em pedaços de
+// tamanho variável como o endpoint CDC faria e escreve o fluxo na saída.
+// No meio, o consumidor para por um tempo para forçar descartes. Os blocos
+// alternam entre TELEMETRY_SAMPLES e TELEMETRY_BLOCK (o da gravação de
+// sessão): o passo da rampa cabe num nibble e a volta de 4095 a 0 escapa.
+//
+// Uso: telemetry_loopback [blocos] | python3 tools/telemetry_decode.py --check-ramp -
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "telemetry.h"
+
+#define BLOCK_SAMPLES 256
+#define READING_EVERY 4     // Uma leitura a cada 4 blocos, como na tarefa de aquisição
+#define STALL_START 200     // Bloco em que o consumidor para...
+#define STALL_BLOCKS 80     // ...e por quantos blocos (estoura o anel de 16 KB)
+
+static telemetry_t ring;
+static uint32_t lcg = 1;
+
+// Mesma rampa conferida por tools/telemetry_decode.py --check-ramp
+static uint16_t ramp(uint32_t block, uint32_t i) {
+    return (block * 131u + i * 7u) & 0x0FFF;
+}
+
+// Pedaços de 1 a 64 bytes, o tamanho de um pacote USB full-speed
+static void drain(uint32_t budget) {
+    const uint8_t *data;
+    uint32_t n;
+    while (budget && (n = telemetry_peek(&ring, &data)) > 0) {
+        lcg = lcg * 1103515245u + 12345u;
+        uint32_t chunk = 1 + (lcg >> 16) % 64;
+        if (chunk > n)
+            chunk = n;
+        if (chunk > budget)
+            chunk = budget;
+        fwrite(data, 1, chunk, stdout);
+        telemetry_consume(&ring, chunk);
+        budget -= chunk;
+    }
+}
+
+int main(int argc, char **argv) {
+    uint32_t blocks = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 1000;
+    uint16_t samples[BLOCK_SAMPLES];
+    telemetry_init(&ring);
+
+    for (uint32_t b = 0; b < blocks; b++) {
+        for (uint32_t i = 0; i < BLOCK_SAMPLES; i++)
+            samples[i] = ramp(b, i);
+        if (b & 1)
+            telemetry_put_block(&ring, b, b * 1280u, samples, BLOCK_SAMPLES);
+        else
+            telemetry_put_samples(&ring, b, samples, BLOCK_SAMPLES);
+        if (b % READING_EVERY == READING_EVERY - 1) {
+            telemetry_reading_t r = {
+                .r_x_mohm = b * 1000u,
+                .closest_mohm = b * 1000u,
+                .media_q8 = ramp(b, 0) << 8,
+                .amostras = b,
+                .dropped_packets = ring.dropped_packets,
+                .estado = 3,
+            };
+            telemetry_put_reading(&ring, &r);
+        }
+        bool stalled = b >= STALL_START && b < STALL_START + STALL_BLOCKS;
+        if (!stalled)
+            drain(600); // Um pouco mais que um bloco por iteração
+    }
+
+    // Leitura final com o total de descartes, depois esvazia tudo
+    drain(UINT32_MAX);
+    telemetry_reading_t fim = {.dropped_packets = ring.dropped_packets, .estado = 3};
+    telemetry_put_reading(&ring, &fim);
+    drain(UINT32_MAX);
+
+    fprintf(stderr, "pacotes %lu, descartados %lu (%lu bytes)\n", (unsigned long)ring.packets,
+            (unsigned long)ring.dropped_packets, (unsigned long)ring.dropped_bytes);
+    return 0;
+}
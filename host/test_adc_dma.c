@@ -0,0 +1,111 @@
+// Entrega dos blocos do ADC pelo ping-pong de DMA, sobre o ADC e o DMA
+// simulados do host (host_adc_push em pico_host.c)
+//
+// Confere a sequência dos blocos (buffers alternados, amostras em ordem e
+// sem perda entre blocos), a decimação em soma/quadrados/extremos, a
+// contagem de blocos não consumidos e a parada/reinício da aquisição.
+
+#include "check.h"
+#include "adc_dma.h"
+#include "hardware/adc.h"
+
+#define N ADC_DMA_BLOCK_SAMPLES
+#define BLOCOS_MAX 16
+
+static const uint16_t *buffers[BLOCOS_MAX];
+static uint16_t primeiras[BLOCOS_MAX];
+static uint entregues;
+static bool em_ordem = true;
+static uint16_t proxima;
+
+static void bloco_pronto(const uint16_t *samples, uint count) {
+    CHECK(count == N, "bloco com %u amostras", count);
+    if (entregues < BLOCOS_MAX) {
+        buffers[entregues] = samples;
+        primeiras[entregues] = samples[0];
+    }
+    entregues++;
+    for (uint i = 0; i < count; i++) {
+        if (samples[i] != proxima)
+            em_ordem = false;
+        proxima = (proxima + 1) & 0x0FFF;
+    }
+}
+
+// Rampa contínua de códigos: a posição de cada amostra é conhecida
+static uint16_t rampa = 0;
+
+static void converte(uint count) {
+    uint16_t amostras[3 * N];
+    for (uint i = 0; i < count; i++) {
+        amostras[i] = rampa;
+        rampa = (rampa + 1) & 0x0FFF;
+    }
+    host_adc_push(amostras, count);
+}
+
+static void testa_sequencia(void) {
+    adc_dma_init(2, 500000);
+    adc_dma_set_callback(bloco_pronto);
+    adc_dma_start();
+
+    converte(N - 1);
+    CHECK(entregues == 0 && !adc_dma_block_ready(), "bloco entregue incompleto");
+    converte(1);
+    CHECK(entregues == 1 && adc_dma_block_ready(), "%u blocos depois de %u amostras", entregues, N);
+
+    // Mais três blocos, entregues em pedaços que não coincidem com o bloco
+    converte(100);
+    converte(2 * N);
+    converte(N - 100);
+    CHECK(entregues == 4, "%u blocos, esperado 4", entregues);
+    CHECK(em_ordem, "amostras fora de ordem ou perdidas entre blocos");
+    CHECK(buffers[0] != buffers[1] && buffers[0] == buffers[2] && buffers[1] == buffers[3],
+          "os blocos não alternam entre as duas metades");
+    CHECK(primeiras[3] == 3 * N, "quarto bloco começa em %u", primeiras[3]);
+
+    // Ninguém leu: cada bloco depois do primeiro encontrou o anterior pendente
+    CHECK(adc_dma_overruns() == 3, "%lu overruns, esperado 3", (unsigned long)adc_dma_overruns());
+    adc_block_t bloco;
+    CHECK(adc_dma_read_block(&bloco), "último bloco não disponível");
+    CHECK(bloco.seq == 4, "sequência %lu", (unsigned long)bloco.seq);
+    // Rampa 768..1023: soma, quadrados e extremos
+    uint64_t q = 0;
+    for (uint32_t c = 3 * N; c < 4 * N; c++)
+        q += c * c;
+    CHECK(bloco.count == N && bloco.sum == (3 * N + 4 * N - 1) * N / 2 && bloco.sum_sq == q &&
+          bloco.min == 3 * N && bloco.max == 4 * N - 1, "decimação do bloco errada");
+    CHECK(!adc_dma_read_block(&bloco), "mesmo bloco lido duas vezes");
+
+    // Consumindo a cada bloco, não há overrun
+    for (int i = 0; i < 4; i++) {
+        converte(N);
+        CHECK(adc_dma_read_block(&bloco) && bloco.seq == (uint32_t)(5 + i), "bloco %d", 5 + i);
+    }
+    CHECK(adc_dma_overruns() == 3, "overrun com os blocos consumidos");
+    CHECK(host_adc_fifo_overflows() == 0, "amostras perdidas na FIFO");
+}
+
+// Parada no meio de um bloco: nada é entregue parado e o reinício começa um
+// bloco novo na primeira metade, descartando o parcial
+static void testa_parada(void) {
+    converte(N / 2);
+    adc_dma_stop();
+    uint antes = entregues;
+    converte(2 * N);
+    CHECK(entregues == antes, "bloco entregue com o ADC parado");
+
+    proxima = rampa;
+    adc_dma_start();
+    converte(N);
+    CHECK(entregues == antes + 1, "reinício não entregou um bloco completo");
+    CHECK(em_ordem, "bloco parcial anterior à parada vazou no reinício");
+    CHECK(buffers[antes] == buffers[0], "reinício não começou pela primeira metade");
+}
+
+int main(void) {
+    proxima = 0;
+    testa_sequencia();
+    testa_parada();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,91 @@
+// Conversão do divisor em ponto fixo contra a versão original em float
+//
+// Limites verificados, para todos os códigos de 0 a 4094:
+// - divider_rx_mohm: erro de no máximo 0,5 mΩ em relação ao R_x exato (a
+//   fração Rk * soma / (FS * n - soma)), com n = 1, 16 e 500 amostras; acima
+//   de ~4,29 MΩ (fora do uint32_t em mΩ) satura em DIVIDER_R_INFINITE
+// - diferença para a fórmula em float de no máximo 0,5 mΩ + 4 ulp do float
+//   (o erro de arredondamento da própria versão em float)
+// - depois da limitação a 510 Ω..100 kΩ, o valor E24 e as faixas são os
+//   mesmos da versão em float
+// - divider_mean_q8: erro menor que 1/256 de código
+
+#include <stdlib.h>
+#include "check.h"
+#include "divider.h"
+#include "e_series.h"
+#include "float_ref.h"
+
+#define FS DIVIDER_ADC_FULL_SCALE
+#define RK_MOHM (REF_R_CONHECIDO * 1000u)
+
+// 2 * |r * den - Rk * soma| <= den  <=>  |r - exato| <= 0,5 mΩ
+static void testa_arredondamento(uint32_t n) {
+    int erros = 0;
+    for (uint32_t c = 0; c < FS; c++) {
+        uint32_t soma = c * n + n / 3; // Média um pouco acima do código inteiro
+        uint32_t r = divider_rx_mohm(soma, n, RK_MOHM);
+        uint64_t den = (uint64_t)FS * n - soma;
+        uint64_t exato = (uint64_t)RK_MOHM * soma;
+        uint64_t aprox = (uint64_t)r * den;
+        uint64_t erro = aprox > exato ? aprox - exato : exato - aprox;
+        bool satura = exato >= (uint64_t)DIVIDER_R_INFINITE * den;
+        if ((satura ? r != DIVIDER_R_INFINITE : 2 * erro > den) && erros++ < 5)
+            CHECK(0, "n %lu, soma %lu: %lu mΩ fora de ±0,5 mΩ", (unsigned long)n, (unsigned long)soma,
+                  (unsigned long)r);
+    }
+    CHECK(erros == 0, "n %lu: %d códigos fora do limite de arredondamento", (unsigned long)n, erros);
+    CHECK(divider_rx_mohm(FS * n, n, RK_MOHM) == DIVIDER_R_INFINITE, "fundo de escala sem saturar");
+}
+
+static void testa_contra_float(void) {
+    int erros = 0;
+    double pior = 0;
+    for (uint32_t c = 0; c < FS; c++) {
+        float r_float = ref_rx_ohm((float)c);
+        uint32_t r = divider_rx_mohm(c, 1, RK_MOHM);
+        double diferenca = fabs(r / 1000.0 - r_float);
+        double limite = 0.0005 + 4.0 * (nextafterf(r_float, INFINITY) - r_float);
+        if (r == DIVIDER_R_INFINITE && r_float * 1000.0 >= DIVIDER_R_INFINITE)
+            diferenca = 0; // Saturado: a limitação abaixo leva os dois a 100 kΩ
+        if (diferenca / limite > pior)
+            pior = diferenca / limite;
+        if (diferenca > limite && erros++ < 5)
+            CHECK(0, "código %lu: %lu mΩ, float %.4f Ω", (unsigned long)c, (unsigned long)r, r_float);
+
+        // Limitação, valor E24 e faixas
+        float comercial_float = ref_closest_e24(ref_clamp(r_float));
+        uint32_t comercial = e_series_nearest(E_SERIES_E24, divider_clamp(r, 510000u, 100000000u));
+        int b1, b2, m;
+        ref_colors(comercial_float, &b1, &b2, &m);
+        uint8_t bands[2], multiplier;
+        e_series_bands(comercial, 2, bands, &multiplier);
+        if ((comercial != (uint32_t)comercial_float * 1000u || bands[0] != b1 || bands[1] != b2 ||
+             multiplier != m) && erros++ < 5)
+            CHECK(0, "código %lu: %lu mΩ %d%d x10^%d, float %.0f Ω %d%d x10^%d", (unsigned long)c,
+                  (unsigned long)comercial, bands[0], bands[1], multiplier, comercial_float, b1, b2, m);
+    }
+    CHECK(erros == 0, "%d códigos divergentes da versão em float", erros);
+    printf("pior diferença para o float: %.2f do limite\n", pior);
+}
+
+static void testa_media(void) {
+    for (uint32_t soma = 0; soma <= FS * 16; soma++) {
+        uint32_t q8 = divider_mean_q8(soma, 16);
+        // soma / 16 - q8 / 256 em [0, 1/256)  <=>  16 * soma - q8 em [0, 16)
+        uint32_t d = soma * 16 - q8;
+        if (soma * 16 < q8 || d >= 16) {
+            CHECK(0, "média de soma %lu: %lu (Q8)", (unsigned long)soma, (unsigned long)q8);
+            break;
+        }
+    }
+}
+
+int main(void) {
+    testa_arredondamento(1);
+    testa_arredondamento(16);
+    testa_arredondamento(500);
+    testa_contra_float();
+    testa_media();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,102 @@
+// Tabela de decisão das séries E contra a busca exaustiva do valor mais próximo
+//
+// Para cada série, resistor conhecido e código do ADC de 0 a 4095, o valor
+// escolhido pelos limiares em Q8 tem de ser o mesmo da busca linear por
+// todos os valores da série, com R_x exato (fração, sem arredondar) e
+// limitado à faixa suportada, como no firmware.
+
+#include "check.h"
+#include "e_series.h"
+
+#define R_MIN_OHM 510
+#define R_MAX_OHM 100000
+#define FS E_SERIES_ADC_FULL_SCALE
+
+// Nominais e um 10 kΩ calibrado fora do valor inteiro em ohms
+static const uint32_t resistores_mohm[] = {1000000u, 10000000u, 47000000u, 9985500u};
+
+// |n/d - v| comparado sem divisão: |n - v * d|
+static uint64_t distancia(uint64_t n, uint64_t d, uint32_t v) {
+    uint64_t vd = (uint64_t)v * d;
+    return n > vd ? n - vd : vd - n;
+}
+
+// Valor da série mais próximo de n/d mΩ, percorrendo todas as décadas;
+// empate fica com o menor, como em e_series_nearest
+static uint32_t mais_proximo(e_series_id_t serie, uint64_t n, uint64_t d) {
+    const e_series_t *s = &e_series_tables[serie];
+    uint32_t melhor = 0;
+    uint64_t d_melhor = UINT64_MAX;
+    for (uint32_t escala = 10; escala <= 1000000u; escala *= 10) {
+        for (uint8_t i = 0; i < s->count; i++) {
+            uint32_t v = s->mantissas[i] * escala;
+            uint64_t dist = distancia(n, d, v);
+            if (dist < d_melhor) {
+                d_melhor = dist;
+                melhor = v;
+            }
+        }
+    }
+    return melhor;
+}
+
+// Busca exaustiva para um código inteiro: R_x = Rk * c / (FS - c), limitado
+static uint32_t referencia(e_series_id_t serie, uint32_t r_known_mohm, uint32_t c) {
+    uint64_t r_min = R_MIN_OHM * 1000ull, r_max = R_MAX_OHM * 1000ull;
+    if (c >= FS)
+        return mais_proximo(serie, r_max, 1);
+    uint64_t n = (uint64_t)r_known_mohm * c, d = FS - c;
+    if (n < r_min * d)
+        return mais_proximo(serie, r_min, 1);
+    if (n > r_max * d)
+        return mais_proximo(serie, r_max, 1);
+    return mais_proximo(serie, n, d);
+}
+
+static e_series_lut_t lut;
+
+static void testa_tabela(e_series_id_t serie, uint32_t r_known_mohm) {
+    CHECK(e_series_lut_build(&lut, serie, r_known_mohm, R_MIN_OHM, R_MAX_OHM), "%s: tabela não coube",
+          e_series_tables[serie].name);
+    int erros = 0;
+    for (uint32_t c = 0; c <= FS; c++) {
+        uint32_t esperado = referencia(serie, r_known_mohm, c);
+        uint32_t obtido = e_series_lut_lookup(&lut, c << 8);
+        if (obtido != esperado && erros++ < 5)
+            CHECK(0, "%s, Rk %lu mΩ, código %lu: %lu mΩ, esperado %lu mΩ", e_series_tables[serie].name,
+                  (unsigned long)r_known_mohm, (unsigned long)c, (unsigned long)obtido, (unsigned long)esperado);
+    }
+    CHECK(erros == 0, "%s, Rk %lu mΩ: %d códigos divergentes", e_series_tables[serie].name,
+          (unsigned long)r_known_mohm, erros);
+}
+
+// e_series_nearest em torno de cada fronteira entre vizinhos (ponto médio e
+// um mΩ para cada lado) e nas pontas de cada década
+static void testa_nearest(e_series_id_t serie) {
+    const e_series_t *s = &e_series_tables[serie];
+    int erros = 0;
+    for (uint32_t escala = 10; escala <= 100000u; escala *= 10) {
+        for (uint8_t i = 0; i < s->count; i++) {
+            uint32_t a = s->mantissas[i] * escala;
+            uint32_t b = i + 1 < s->count ? s->mantissas[i + 1] * escala : 100u * escala * 10;
+            uint32_t meio = a + (b - a) / 2;
+            uint32_t r[] = {a - 1, a, a + 1, meio - 1, meio, meio + 1, b - 1};
+            for (unsigned k = 0; k < sizeof(r) / sizeof(r[0]); k++) {
+                uint32_t esperado = mais_proximo(serie, r[k], 1);
+                if (e_series_nearest(serie, r[k]) != esperado && erros++ < 5)
+                    CHECK(0, "%s: nearest(%lu mΩ) = %lu, esperado %lu", s->name, (unsigned long)r[k],
+                          (unsigned long)e_series_nearest(serie, r[k]), (unsigned long)esperado);
+            }
+        }
+    }
+    CHECK(erros == 0, "%s: %d valores divergentes em e_series_nearest", s->name, erros);
+}
+
+int main(void) {
+    for (int serie = 0; serie < E_SERIES_COUNT; serie++) {
+        for (unsigned i = 0; i < sizeof(resistores_mohm) / sizeof(resistores_mohm[0]); i++)
+            testa_tabela((e_series_id_t)serie, resistores_mohm[i]);
+        testa_nearest((e_series_id_t)serie);
+    }
+    return CHECK_RESULT();
+}
@@ -0,0 +1,129 @@
+// Filtro robusto e estatística sobre sequências de amostras gravadas
+//
+// As sequências imitam uma captura do divisor: ruído de ±3 códigos, picos
+// isolados, um trecho de contato ruim e a troca de peça no meio de um bloco.
+// São fixas (LCG com semente constante), então o resultado é reproduzível.
+
+#include <math.h>
+#include <stdlib.h>
+#include "check.h"
+#include "robust_filter.h"
+#include "stats.h"
+
+#define BLOCO 256
+#define BLOCOS_A 64        // Peça A (código 2047)
+#define BLOCOS_B 32        // Peça B (código 1300)
+#define TROCA 96           // Amostra do primeiro bloco de B em que a peça troca
+#define CODIGO_A 2047
+#define CODIGO_B 1300
+
+// Mesma configuração do firmware (FILTER_* em lib/meter.c)
+#define IIR_SHIFT 2
+#define DESVIO_MIN_Q4 48
+#define DEGRAU_GRUPOS 4
+
+static uint16_t gravacao[(BLOCOS_A + BLOCOS_B) * BLOCO];
+
+static void grava_sequencia(void) {
+    uint32_t lcg = 2024;
+    for (uint32_t i = 0; i < sizeof(gravacao) / sizeof(gravacao[0]); i++) {
+        lcg = lcg * 1103515245u + 12345u;
+        uint32_t b = i / BLOCO, k = i % BLOCO;
+        bool peca_b = b > BLOCOS_A || (b == BLOCOS_A && k >= TROCA);
+        int codigo = (peca_b ? CODIGO_B : CODIGO_A) + (int)((lcg >> 16) % 7) - 3;
+        if (!peca_b && (lcg >> 8) % 97 == 0)
+            codigo = (lcg & 1) ? 4095 : 0; // Pico isolado
+        if (b == 10 && k >= 40 && k < 60)
+            codigo = 3000; // Contato ruim
+        gravacao[i] = (uint16_t)codigo;
+    }
+}
+
+static void testa_sequencia(const uint16_t *correcao) {
+    robust_filter_t f;
+    stats_t aceitos;
+    robust_filter_init(&f, IIR_SHIFT, DESVIO_MIN_Q4, DEGRAU_GRUPOS);
+    robust_filter_set_correction(&f, correcao);
+    stats_reset(&aceitos);
+
+    for (int b = 0; b < BLOCOS_A; b++)
+        CHECK(!robust_filter_block(&f, &gravacao[b * BLOCO], BLOCO, &aceitos), "degrau falso no bloco %d", b);
+    CHECK(f.outliers > 0, "nenhum pico descartado");
+    CHECK(labs((long)robust_filter_estimate_q8(&f) - CODIGO_A * 256) <= 64,
+          "estimativa de A %lu (Q8)", (unsigned long)robust_filter_estimate_q8(&f));
+    CHECK(labs((long)stats_mean_q8(&aceitos) - CODIGO_A * 256) <= 64,
+          "média aceita de A %lu (Q8): picos entraram", (unsigned long)stats_mean_q8(&aceitos));
+
+    // Troca no bloco BLOCOS_A: os DEGRAU_GRUPOS primeiros grupos de B formam
+    // o degrau e todos os grupos de B do bloco ficam em `aceitos`
+    CHECK(robust_filter_block(&f, &gravacao[BLOCOS_A * BLOCO], BLOCO, &aceitos), "troca sem degrau");
+    CHECK(f.steps == 1, "%lu degraus", (unsigned long)f.steps);
+    CHECK(aceitos.n == BLOCO - TROCA, "%lu amostras aceitas depois do degrau, esperado %d",
+          (unsigned long)aceitos.n, BLOCO - TROCA);
+    CHECK(labs((long)stats_mean_q8(&aceitos) - CODIGO_B * 256) <= 64,
+          "média aceita depois do degrau %lu (Q8)", (unsigned long)stats_mean_q8(&aceitos));
+
+    for (int b = BLOCOS_A + 1; b < BLOCOS_A + BLOCOS_B; b++)
+        robust_filter_block(&f, &gravacao[b * BLOCO], BLOCO, &aceitos);
+    CHECK(f.steps == 1, "%lu degraus em B", (unsigned long)f.steps);
+    CHECK(labs((long)robust_filter_estimate_q8(&f) - CODIGO_B * 256) <= 64,
+          "estimativa de B %lu (Q8)", (unsigned long)robust_filter_estimate_q8(&f));
+}
+
+// A mesma gravação sempre produz a mesma saída, bloco a bloco
+static void testa_determinismo(void) {
+    robust_filter_t f1, f2;
+    stats_t s1, s2;
+    robust_filter_init(&f1, IIR_SHIFT, DESVIO_MIN_Q4, DEGRAU_GRUPOS);
+    robust_filter_init(&f2, IIR_SHIFT, DESVIO_MIN_Q4, DEGRAU_GRUPOS);
+    stats_reset(&s1);
+    stats_reset(&s2);
+    for (int b = 0; b < BLOCOS_A + BLOCOS_B; b++) {
+        robust_filter_block(&f1, &gravacao[b * BLOCO], BLOCO, &s1);
+        robust_filter_block(&f2, &gravacao[b * BLOCO], BLOCO, &s2);
+        CHECK(f1.estimate_q8 == f2.estimate_q8 && s1.n == s2.n && s1.sum == s2.sum && s1.sum_sq == s2.sum_sq,
+              "saídas diferentes no bloco %d", b);
+    }
+}
+
+// Acumuladores inteiros contra média e variância em double, e o esquecimento
+static void testa_estatistica(void) {
+    const uint16_t *b = &gravacao[(BLOCOS_A + 1) * BLOCO];
+    uint32_t n = (BLOCOS_B - 1) * BLOCO;
+    stats_t s;
+    stats_reset(&s);
+    double soma = 0, soma_q = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        stats_add_block(&s, 1, b[i], (uint64_t)b[i] * b[i]);
+        soma += b[i];
+    }
+    double media = soma / n;
+    for (uint32_t i = 0; i < n; i++)
+        soma_q += (b[i] - media) * (b[i] - media);
+    double var_media = soma_q / (n - 1) / n;
+    CHECK(fabs(stats_mean_q8(&s) / 256.0 - media) < 1 / 256.0, "média %f", stats_mean_q8(&s) / 256.0);
+    CHECK(fabs(stats_mean_var_q16(&s) / 65536.0 - var_media) < 2 / 65536.0 + var_media * 0.01,
+          "variância da média %g, esperado %g", stats_mean_var_q16(&s) / 65536.0, var_media);
+
+    // Cinco amostras iguais a 3: depois do esquecimento n = 2, Σx = 7 e
+    // Σx² = 22, e n * Σx² - (Σx)² = -5 sem a trava em 0
+    stats_reset(&s);
+    stats_add_block(&s, 5, 15, 45);
+    stats_decay(&s);
+    CHECK(stats_mean_var_q16(&s) == 0, "variância %llu depois do esquecimento",
+          (unsigned long long)stats_mean_var_q16(&s));
+    CHECK(stats_isqrt(4095ull * 4095) == 4095 && stats_isqrt(4095ull * 4095 - 1) == 4094, "isqrt");
+}
+
+int main(void) {
+    static uint16_t identidade_q4[4096];
+    for (int c = 0; c < 4096; c++)
+        identidade_q4[c] = (uint16_t)(c << 4);
+
+    grava_sequencia();
+    testa_sequencia(NULL);
+    testa_sequencia(identidade_q4); // Tabela identidade: mesmo resultado do ADC ideal
+    testa_determinismo();
+    testa_estatistica();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,80 @@
+// Seqlock com um escritor e um leitor em threads do host, como os dois cores
+//
+// O escritor publica registros em que todas as palavras derivam do mesmo
+// contador; o leitor confere que nenhuma cópia mistura duas publicações e
+// que as versões só crescem. O alvo compila com -fsanitize=thread quando o
+// compilador suporta, para o sanitizador apontar qualquer acesso sem
+// sincronização entre as threads.
+
+#include <pthread.h>
+#include "check.h"
+#include "seqlock.h"
+
+#define PUBLICACOES 200000u
+
+typedef struct {
+    uint32_t contador;
+    uint32_t palavras[SEQLOCK_MAX_WORDS - 2];
+    uint32_t verificacao;
+} registro_t;
+
+SEQLOCK_ASSERT_FITS(registro_t);
+
+static seqlock_t lock;
+
+static void monta(registro_t *r, uint32_t k) {
+    r->contador = k;
+    r->verificacao = k;
+    for (int i = 0; i < SEQLOCK_MAX_WORDS - 2; i++) {
+        r->palavras[i] = k * 2654435761u + i;
+        r->verificacao ^= r->palavras[i];
+    }
+}
+
+static bool consistente(const registro_t *r) {
+    uint32_t v = r->contador;
+    for (int i = 0; i < SEQLOCK_MAX_WORDS - 2; i++) {
+        if (r->palavras[i] != r->contador * 2654435761u + i)
+            return false;
+        v ^= r->palavras[i];
+    }
+    return v == r->verificacao;
+}
+
+static void *escritor(void *arg) {
+    (void)arg;
+    registro_t r;
+    for (uint32_t k = 1; k <= PUBLICACOES; k++) {
+        monta(&r, k);
+        seqlock_write(&lock, &r, sizeof(r));
+    }
+    return NULL;
+}
+
+int main(void) {
+    seqlock_init(&lock);
+    pthread_t t;
+    pthread_create(&t, NULL, escritor, NULL);
+
+    uint32_t leituras = 0, rasgadas = 0, versao_anterior = 0, contador_anterior = 0;
+    registro_t r;
+    do {
+        uint32_t versao = seqlock_read(&lock, &r, sizeof(r));
+        leituras++;
+        if (versao == 0)
+            continue; // Nada publicado ainda
+        if (!consistente(&r))
+            rasgadas++;
+        CHECK(versao >= versao_anterior && r.contador >= contador_anterior,
+              "versão voltou: %lu depois de %lu", (unsigned long)versao, (unsigned long)versao_anterior);
+        CHECK(r.contador == versao, "registro %lu com versão %lu", (unsigned long)r.contador, (unsigned long)versao);
+        versao_anterior = versao;
+        contador_anterior = r.contador;
+    } while (contador_anterior < PUBLICACOES);
+    pthread_join(t, NULL);
+
+    CHECK(rasgadas == 0, "%lu de %lu leituras misturaram duas publicações", (unsigned long)rasgadas,
+          (unsigned long)leituras);
+    CHECK(seqlock_version(&lock) == PUBLICACOES, "versão final %lu", (unsigned long)seqlock_version(&lock));
+    return CHECK_RESULT();
+}
@@ -0,0 +1,250 @@
+// Quadros do SSD1306 vistos do barramento I2C (host_i2c_set_sink)
+//
+// Um modelo do controlador interpreta as transações como o display: bytes de
+// controle, comandos de endereçamento (modo, janela de colunas e páginas) e
+// dados gravados na GDDRAM com o incremento do modo ativo. Depois de cada
+// envio a GDDRAM simulada tem de ser igual ao framebuffer, e os bytes no
+// barramento têm de bater com flush_bytes: assim um envio parcial que deixa
+// de fora uma região alterada, ou escreve fora da janela, aparece no teste.
+
+#include <string.h>
+#include "check.h"
+#include "ssd1306.h"
+
+#define ENDERECO 0x3C
+#define PAGINAS (HEIGHT / 8)
+#define QUADRO_COMPLETO (8 + PAGINAS * WIDTH) // Janela, controle e a GDDRAM inteira
+
+static ssd1306_t ssd;
+
+// Estado do controlador
+static uint8_t gddram[PAGINAS][WIDTH];
+static uint8_t modo = 0x02; // Endereçamento por página depois do reset
+static uint8_t col0 = 0, col1 = WIDTH - 1, pag0 = 0, pag1 = PAGINAS - 1;
+static uint8_t col = 0, pag = 0;
+static bool ligado = false;
+
+// Barramento
+static uint32_t transacoes, bytes_barramento;
+static bool endereco_errado, controle_invalido;
+
+// Bytes de argumento de cada comando com parâmetros
+static int argumentos(uint8_t cmd) {
+    switch (cmd) {
+    case SET_MEM_ADDR: case SET_CONTRAST: case SET_MUX_RATIO: case SET_DISP_OFFSET:
+    case SET_COM_PIN_CFG: case SET_DISP_CLK_DIV: case SET_PRECHARGE: case SET_VCOM_DESEL:
+    case SET_CHARGE_PUMP:
+        return 1;
+    case SET_COL_ADDR: case SET_PAGE_ADDR:
+        return 2;
+    case SET_HSCROLL_RIGHT: case SET_HSCROLL_LEFT:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+static void comando(const uint8_t *c) {
+    switch (c[0]) {
+    case SET_MEM_ADDR:
+        modo = c[1] & 0x03;
+        break;
+    case SET_COL_ADDR:
+        col0 = col = c[1] & 0x7F;
+        col1 = c[2] & 0x7F;
+        break;
+    case SET_PAGE_ADDR:
+        pag0 = pag = c[1] & 0x07;
+        pag1 = c[2] & 0x07;
+        break;
+    case SET_DISP:
+    case SET_DISP | 0x01:
+        ligado = c[0] & 0x01;
+        break;
+    }
+}
+
+static void dado(uint8_t byte) {
+    gddram[pag][col] = byte;
+    if (modo == 0x01) { // Vertical: desce as páginas, depois a próxima coluna
+        if (pag++ >= pag1) {
+            pag = pag0;
+            col = col >= col1 ? col0 : col + 1;
+        }
+    } else { // Horizontal (e página, sem mudar de página)
+        if (col++ >= col1) {
+            col = col0;
+            if (modo == 0x00)
+                pag = pag >= pag1 ? pag0 : pag + 1;
+        }
+    }
+}
+
+// Uma transação: sequência de byte de controle (Co, D/C#) e conteúdo. Com
+// Co = 0 o resto da transação é só comandos ou só dados.
+static void display_recebe(uint8_t addr, const uint8_t *data, size_t len) {
+    transacoes++;
+    bytes_barramento += len;
+    if (addr != ENDERECO)
+        endereco_errado = true;
+
+    uint8_t cmd[8];
+    int pendentes = -1, n = 0;
+    size_t i = 0;
+    while (i < len) {
+        uint8_t controle = data[i++];
+        bool continua = controle & 0x80, dados = controle & 0x40;
+        if (controle & 0x3F)
+            controle_invalido = true;
+        do {
+            if (i >= len)
+                break;
+            uint8_t b = data[i++];
+            if (dados) {
+                dado(b);
+            } else if (pendentes < 0) {
+                cmd[0] = b;
+                n = 1;
+                pendentes = argumentos(b);
+            } else {
+                cmd[n++] = b;
+                pendentes--;
+            }
+            if (pendentes == 0) {
+                comando(cmd);
+                pendentes = -1;
+            }
+        } while (!continua);
+    }
+}
+
+static uint8_t framebuffer(uint8_t x, uint8_t p) {
+    return ssd.ram_buffer[x * ssd.pages + p + 1];
+}
+
+static int diferencas(void) {
+    int d = 0;
+    for (uint8_t p = 0; p < PAGINAS; p++)
+        for (uint8_t x = 0; x < WIDTH; x++)
+            d += gddram[p][x] != framebuffer(x, p);
+    return d;
+}
+
+// Envia o que mudou e confere a GDDRAM e a contagem de bytes
+static uint32_t envia(const char *etapa) {
+    uint32_t antes = bytes_barramento;
+    CHECK(ssd1306_present(&ssd), "%s: display ocupado", etapa);
+    CHECK(!ssd1306_busy(&ssd), "%s: transferência não terminou", etapa);
+    uint32_t enviados = bytes_barramento - antes;
+    CHECK(enviados == ssd.flush_bytes, "%s: %lu bytes no barramento, flush_bytes %lu", etapa,
+          (unsigned long)enviados, (unsigned long)ssd.flush_bytes);
+    int d = diferencas();
+    CHECK(d == 0, "%s: %d bytes da GDDRAM diferentes do framebuffer", etapa, d);
+    return enviados;
+}
+
+static void testa_inicio(void) {
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, ENDERECO, i2c1);
+    ssd1306_config(&ssd);
+    CHECK(ligado && modo == 0x01, "configuração: display %s, modo %u", ligado ? "ligado" : "desligado", modo);
+
+    memset(gddram, 0xA5, sizeof(gddram)); // Conteúdo qualquer antes do primeiro envio
+    ssd1306_fill(&ssd, false);
+    ssd1306_draw_string(&ssd, "1:Marrom", 8, 6);
+    ssd1306_send_full(&ssd);
+    CHECK(ssd.flush_bytes == QUADRO_COMPLETO, "quadro completo com %lu bytes", (unsigned long)ssd.flush_bytes);
+    CHECK(diferencas() == 0, "quadro completo não chegou inteiro ao display");
+
+    uint32_t t = transacoes;
+    CHECK(envia("sem mudanças") == 0 && transacoes == t, "quadro sem mudanças gerou transações");
+}
+
+static void testa_janelas(void) {
+    // Um caractere trocado: uma janela de 8 colunas numa página
+    ssd1306_draw_string(&ssd, "1:Marrim", 8, 8);
+    ssd1306_draw_string(&ssd, "1:Marrom", 8, 8);
+    envia("texto deslocado");
+    ssd1306_draw_string(&ssd, "1:Marrim", 8, 8);
+    uint32_t n = envia("um caractere");
+    CHECK(n <= 8 + 2 * 8, "um caractere custou %lu bytes", (unsigned long)n);
+
+    // Redesenhar o mesmo conteúdo não envia nada
+    ssd1306_fill(&ssd, false);
+    ssd1306_draw_string(&ssd, "1:Marrom", 8, 6);
+    ssd1306_draw_string(&ssd, "1:Marrim", 8, 8);
+    CHECK(envia("redesenho idêntico") == 0, "redesenho idêntico enviou bytes");
+
+    // Pixels em cantos opostos: duas janelas pequenas, não o retângulo entre elas
+    ssd1306_pixel(&ssd, 0, 0, true);
+    ssd1306_pixel(&ssd, WIDTH - 1, HEIGHT - 1, true);
+    n = envia("cantos");
+    CHECK(n == 2 * (8 + 1), "dois pixels custaram %lu bytes", (unsigned long)n);
+
+    // Depois de parar a rolagem a RAM do display é reenviada inteira
+    ssd1306_scroll_horizontal(&ssd, false, 0, 7, 0);
+    ssd1306_scroll_stop(&ssd);
+    CHECK(envia("depois da rolagem") == QUADRO_COMPLETO, "rolagem parada sem reenvio completo");
+}
+
+// Sequências pseudoaleatórias de primitivas, com envios a cada poucas
+static uint32_t semente = 12345;
+
+static uint32_t aleatorio(uint32_t n) {
+    semente = semente * 1664525u + 1013904223u;
+    return (semente >> 8) % n;
+}
+
+static void testa_aleatorio(void) {
+    char texto[6];
+    for (int quadro = 0; quadro < 400; quadro++) {
+        int primitivas = 1 + aleatorio(4);
+        for (int k = 0; k < primitivas; k++) {
+            uint8_t x = aleatorio(WIDTH), y = aleatorio(HEIGHT);
+            bool v = aleatorio(2);
+            switch (aleatorio(8)) {
+            case 0:
+                ssd1306_pixel(&ssd, x, y, v);
+                break;
+            case 1:
+                ssd1306_fill_rect(&ssd, x, y, x + aleatorio(40), y + aleatorio(20), v);
+                break;
+            case 2:
+                ssd1306_rect(&ssd, y, x, 1 + aleatorio(40), 1 + aleatorio(30), v, aleatorio(2));
+                break;
+            case 3:
+                ssd1306_line(&ssd, x, y, aleatorio(WIDTH), aleatorio(HEIGHT), v);
+                break;
+            case 4:
+                ssd1306_hline(&ssd, x, aleatorio(WIDTH), y, v);
+                break;
+            case 5:
+                ssd1306_vline(&ssd, x, y, aleatorio(HEIGHT), v);
+                break;
+            case 6:
+                snprintf(texto, sizeof(texto), "%u", (unsigned)aleatorio(100000));
+                ssd1306_draw_string(&ssd, texto, x, y);
+                break;
+            default:
+                if (aleatorio(16) == 0)
+                    ssd1306_fill(&ssd, v);
+                break;
+            }
+        }
+        char etapa[32];
+        snprintf(etapa, sizeof(etapa), "quadro aleatório %d", quadro);
+        uint32_t n = envia(etapa);
+        CHECK(n <= QUADRO_COMPLETO + 8 * PAGINAS, "%s: %lu bytes", etapa, (unsigned long)n);
+    }
+}
+
+int main(void) {
+    host_i2c_set_sink(i2c1, display_recebe);
+    testa_inicio();
+    testa_janelas();
+    testa_aleatorio();
+    CHECK(!endereco_errado, "transação para outro endereço");
+    CHECK(!controle_invalido, "byte de controle inválido");
+    CHECK(ssd.total_bytes == bytes_barramento, "total_bytes %lu, barramento %lu", (unsigned long)ssd.total_bytes,
+          (unsigned long)bytes_barramento);
+    return CHECK_RESULT();
+}
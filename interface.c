@@ -0,0 +1,826 @@
+// Core 0: interface (display, LEDs e botões)
+//
+// Desenho da tela em cada modo de exibição, matriz de LEDs e os botões A
+// (modo) e do joystick (série). As leituras chegam do core 1 pelo seqlock
+// de lib/meter.c; a tela e a matriz só são redesenhadas quando o que
+// mostram muda.
+
+#include <stdio.h>
+#include <string.h>
+#include "interface.h"
+#include "lib/ws2818b.h"
+#include "lib/led_anim.h"
+#include "lib/e_series.h"
+#include "lib/probe.h"
+#include "lib/format.h"
+#include "lib/prof.h"
+#include "lib/binning.h"
+#include "lib/trend.h"
+#include "hardware/sync.h"
+
+#define PERIODO_LEDS_MS 50        // Atualização da matriz de LEDs
+#define PERIODO_LEDS_CONTINUIDADE_US 2000 // Matriz acompanha o bipe de perto
+#define PERIODO_TELA_CONTINUIDADE_MS 250  // A tela não tem pressa nesse modo
+#define TENDENCIA_PONTO_MS 200     // Um ponto do gráfico a cada 200 ms (25,6 s na tela)
+#define TENDENCIA_TOPO 10          // Área do gráfico (linhas do display)
+#define TENDENCIA_BASE 63
+
+// Definição das cores das faixas para resistores
+static const char *const color_names[] = {"Preto", "Marrom", "Vermelho", "Laranja", "Amarelo", "Verde", "Azul", "Violeta", "Cinza", "Branco"};
+// Siglas de 3 letras para a tela avançada, onde os nomes inteiros não cabem
+static const char *const color_siglas[] = {"Pre", "Mar", "Vrm", "Lar", "Ama", "Vrd", "Azu", "Vio", "Cin", "Bra"};
+
+// Definição das cores em formato RGB para uso na matriz de LEDs
+static const uint8_t color_rgb[][3] = {
+    {0, 0, 0},       // Preto
+    {90, 40, 10},    // Marrom
+    {200, 0, 0},     // Vermelho
+    {255, 100, 0},   // Laranja
+    {255, 200, 0},   // Amarelo
+    {0, 180, 0},     // Verde
+    {0, 0, 255},     // Azul
+    {130, 0, 150},   // Violeta
+    {120, 120, 120}, // Cinza
+    {255, 255, 255}, // Branco
+    {180, 150, 0}    // Dourado
+};
+
+// Desenha um resistor com as cores correspondentes no display
+void draw_resistor_with_colors(ssd1306_t *ssd, const uint8_t *bands, int digits, int multiplier)
+{
+    // Corpo do resistor (ssd1306_rect recebe topo e esquerda, nessa ordem)
+    ssd1306_rect(ssd, 3, 32, 64, 15, true, false);
+
+    // Terminais
+    ssd1306_line(ssd, 20, 10, 32, 10, true);
+    ssd1306_line(ssd, 96, 10, 108, 10, true);
+
+    // Faixas dos dígitos e faixa multiplicadora; com 3 dígitos (E48 a E192)
+    // as faixas ficam mais estreitas e juntas para as 4 caberem no corpo
+    int passo = digits == 3 ? 13 : 15;
+    int largura = digits == 3 ? 8 : 10;
+    for (int i = 0; i <= digits; i++)
+    {
+        ssd1306_rect(ssd, 3, 37 + passo * i, largura, 15, true, true);
+    }
+
+    // Siglas das cores abaixo do resistor, duas por linha (acima das
+    // informações da linha 38)
+    char text_buffer[12];
+    for (int i = 0; i <= digits; i++)
+    {
+        if (i < digits)
+        {
+            sprintf(text_buffer, "%d:%s", i + 1, color_siglas[bands[i]]);
+        }
+        else
+        {
+            sprintf(text_buffer, "M:%s", color_siglas[multiplier]);
+        }
+        ssd1306_draw_string(ssd, text_buffer, 5 + 48 * (i % 2), 20 + 9 * (i / 2));
+    }
+}
+
+// Exibe as cores do resistor na matriz de LEDs; false se a matriz ainda
+// estava ocupada com o quadro anterior (nada foi enviado)
+bool display_resistor_colors_on_matrix(const uint8_t *bands, int digits, int multiplier)
+{
+    // Limpa todos os LEDs
+    clear_leds();
+
+    // Para uma matriz 5x5, usamos uma linha para cada cor, de baixo para cima:
+    // Linha 5 (LEDs 20-24): primeira faixa, linha 4 (15-19): segunda faixa,
+    // linha 3 (10-14): terceira faixa ou multiplicador, linha 2 (5-9): multiplicador
+    for (int band = 0; band <= digits; band++)
+    {
+        int color = band < digits ? bands[band] : multiplier;
+        int first_led = 20 - 5 * band;
+        for (int i = first_led; i < first_led + 5; i++)
+        {
+            set_led(i, color_rgb[color][0], color_rgb[color][1], color_rgb[color][2]);
+        }
+    }
+
+    // Atualiza a matriz de LEDs (por DMA; quadros repetidos são descartados)
+    return write_leds_async();
+}
+
+// Padrões 5x5 do modo de separação (bit i = LED i; LEDs 20-24 na linha de cima)
+static const uint32_t padrao_classe[BIN_COUNT] = {
+    0,         // Nenhuma peça
+    0x1FFFFFF, // OK: matriz toda verde
+    0x477C84,  // Alto: seta para cima
+    0x427DC4,  // Baixo: seta para baixo
+    0x1151151, // Valor errado: X
+};
+static const uint8_t cor_classe[BIN_COUNT] = {0, 5, 4, 4, 2}; // Índices de color_rgb
+
+// Exibe o resultado da peça na matriz; false se a matriz estava ocupada
+bool display_class_on_matrix(uint8_t classe)
+{
+    clear_leds();
+    const uint8_t *cor = color_rgb[cor_classe[classe]];
+    for (int i = 0; i < LED_COUNT; i++)
+    {
+        if (padrao_classe[classe] & (1u << i))
+        {
+            set_led(i, cor[0], cor[1], cor[2]);
+        }
+    }
+    return write_leds_async();
+}
+
+// O que a matriz mostra de um canal (faixas ou resultado da separação)
+typedef struct
+{
+    uint8_t digits, multiplier, bands[3], classe;
+} matriz_canal_t;
+
+// Varredura: uma linha por canal, de cima para baixo com uma linha apagada
+// entre eles, e as faixas (dígitos e multiplicador) da esquerda para a direita
+bool display_channels_on_matrix(const matriz_canal_t *canal)
+{
+    clear_leds();
+    for (int c = 0; c < CANAIS; c++)
+    {
+        int first_led = 20 - 10 * c;
+        for (int band = 0; canal[c].digits && band <= canal[c].digits; band++)
+        {
+            int color = band < canal[c].digits ? canal[c].bands[band] : canal[c].multiplier;
+            set_led(first_led + band, color_rgb[color][0], color_rgb[color][1], color_rgb[color][2]);
+        }
+    }
+    return write_leds_async();
+}
+
+// Tela do modo de separação: alvo, resultado da peça atual, contagem por
+// classe e ritmo
+static void render_separacao(ssd1306_t *ssd, const meter_reading_t *leitura)
+{
+    static const char *const nome_classe[BIN_COUNT] = {"", "OK", "ALTO", "BAIXO", "ERRADO"};
+    char linha[32], valor[16];
+
+    ssd1306_rect(ssd, 3, 3, 122, 60, true, false);
+    if (leitura->nominal_mohm)
+    {
+        format_resistance_value(leitura->nominal_mohm, valor, sizeof(valor));
+        snprintf(linha, sizeof(linha), "Alvo %s", valor);
+    }
+    else
+    {
+        snprintf(linha, sizeof(linha), "Insira padrao");
+    }
+    ssd1306_draw_string(ssd, linha, 8, 6);
+    ssd1306_line(ssd, 3, 15, 123, 15, true);
+
+    if ((leitura->estado == PROBE_STABLE || leitura->estado == PROBE_HOLD) && leitura->classe != BIN_NONE)
+    {
+        // Desvio em décimos de %, arredondado
+        int32_t decimos = (leitura->desvio_ppm + (leitura->desvio_ppm < 0 ? -500 : 500)) / 1000;
+        uint32_t abs_decimos = decimos < 0 ? -decimos : decimos;
+        snprintf(linha, sizeof(linha), "%s %c%lu.%lu%%", nome_classe[leitura->classe], decimos < 0 ? '-' : '+',
+                 (unsigned long)(abs_decimos / 10), (unsigned long)(abs_decimos % 10));
+    }
+    else if (leitura->estado == PROBE_SETTLING)
+    {
+        snprintf(linha, sizeof(linha), "Medindo...");
+    }
+    else
+    {
+        snprintf(linha, sizeof(linha), leitura->estado == PROBE_SHORT ? "Curto" : "Insira a peca");
+    }
+    ssd1306_draw_string(ssd, linha, 8, 19);
+    ssd1306_line(ssd, 3, 28, 123, 28, true);
+
+    snprintf(linha, sizeof(linha), "OK %lu AL %lu", (unsigned long)leitura->contagem[BIN_PASS - 1],
+             (unsigned long)leitura->contagem[BIN_HIGH - 1]);
+    ssd1306_draw_string(ssd, linha, 8, 32);
+    snprintf(linha, sizeof(linha), "BX %lu ER %lu", (unsigned long)leitura->contagem[BIN_LOW - 1],
+             (unsigned long)leitura->contagem[BIN_WRONG - 1]);
+    ssd1306_draw_string(ssd, linha, 8, 42);
+    uint16_t tol = meter_binning_tolerance(); // A da série ou a definida pelo console
+    snprintf(linha, sizeof(linha), "%u/min +-%u.%u%%", leitura->pecas_min, tol / 10, tol % 10);
+    ssd1306_draw_string(ssd, linha, 8, 52);
+}
+
+// Histórico do gráfico de tendência (core 0)
+static trend_t tendencia;
+
+// Cabeçalho do gráfico: último valor e variação pico a pico da janela
+static void render_tendencia_cabecalho(ssd1306_t *ssd, uint32_t r_mohm)
+{
+    char texto[48], valor[16];
+    ssd1306_fill_rect(ssd, 0, 0, WIDTH - 1, 7, false);
+    uint32_t min, max;
+    if (r_mohm == 0 || !trend_range(&tendencia, &min, &max))
+    {
+        ssd1306_draw_string(ssd, "Sem peca", 0, 0);
+        return;
+    }
+    format_resistance_value(r_mohm, valor, sizeof(valor));
+    uint32_t pp_permil = (uint32_t)(((uint64_t)(max - min) * 1000 + max / 2) / max);
+    snprintf(texto, sizeof(texto), "%s pp%lu.%lu%%", valor, (unsigned long)(pp_permil / 10),
+             (unsigned long)(pp_permil % 10));
+    ssd1306_draw_string(ssd, texto, 0, 0);
+}
+
+// Coluna x do gráfico: segmento vertical do ponto anterior até este, para o
+// traço ficar contínuo mesmo com variações bruscas
+static void render_tendencia_coluna(ssd1306_t *ssd, uint32_t x)
+{
+    ssd1306_vline(ssd, x, TENDENCIA_TOPO, TENDENCIA_BASE, false);
+    uint32_t v = trend_at(&tendencia, x);
+    if (v == 0)
+    {
+        return;
+    }
+    int y = trend_y(&tendencia, v, TENDENCIA_TOPO, TENDENCIA_BASE);
+    uint32_t anterior = x > 0 ? trend_at(&tendencia, x - 1) : 0;
+    int y0 = anterior ? trend_y(&tendencia, anterior, TENDENCIA_TOPO, TENDENCIA_BASE) : y;
+    ssd1306_vline(ssd, x, y0 < y ? y0 : y, y0 < y ? y : y0, true);
+}
+
+// Faixa apagada à frente do ponto mais novo (o cursor da varredura)
+static void render_tendencia_cursor(ssd1306_t *ssd)
+{
+    uint32_t x = (tendencia.count - 1) % TREND_POINTS;
+    for (uint32_t i = 1; i <= 2; i++)
+    {
+        ssd1306_vline(ssd, (x + i) % TREND_POINTS, TENDENCIA_TOPO, TENDENCIA_BASE, false);
+    }
+}
+
+// Gráfico inteiro (entrada no modo ou mudança de escala)
+static void render_tendencia(ssd1306_t *ssd, const meter_reading_t *leitura)
+{
+    render_tendencia_cabecalho(ssd, trend_at(&tendencia, tendencia.count ? tendencia.count - 1 : 0));
+    ssd1306_hline(ssd, 0, WIDTH - 1, 8, true);
+    if (tendencia.count == 0)
+    {
+        return;
+    }
+    uint32_t n = tendencia.count < TREND_POINTS ? tendencia.count : TREND_POINTS;
+    for (uint32_t x = 0; x < n; x++)
+    {
+        render_tendencia_coluna(ssd, x);
+    }
+    render_tendencia_cursor(ssd);
+}
+
+// Continuidade: resultado e atrasos de detecção, redesenhados sem pressa
+static void render_continuidade(ssd1306_t *ssd)
+{
+    char linha[24];
+    ssd1306_rect(ssd, 3, 3, 122, 60, true, false);
+    ssd1306_draw_string(ssd, "Continuidade", 8, 6);
+    snprintf(linha, sizeof(linha), "Limite %u Ohm", METER_CONTINUITY_LIMIT_OHM);
+    ssd1306_draw_string(ssd, linha, 8, 16);
+    ssd1306_line(ssd, 3, 26, 123, 26, true);
+    meter_continuity_t continuidade = meter_continuity();
+    ssd1306_draw_string(ssd, continuidade.closed ? "FECHADO" : "ABERTO", 8, 30);
+    uint32_t atraso = continuidade.delay_us, maximo = continuidade.delay_max_us;
+    snprintf(linha, sizeof(linha), "Atraso %lu.%lu ms", (unsigned long)(atraso / 1000), (unsigned long)(atraso / 100 % 10));
+    ssd1306_draw_string(ssd, linha, 8, 42);
+    snprintf(linha, sizeof(linha), "Max %lu.%lu ms", (unsigned long)(maximo / 1000), (unsigned long)(maximo / 100 % 10));
+    ssd1306_draw_string(ssd, linha, 8, 52);
+}
+
+// Varredura: duas linhas por canal, o valor medido e o valor comercial (ou
+// o estado da ponta)
+static void render_canais(ssd1306_t *ssd, const meter_reading_t *leitura)
+{
+    char linha[24], valor[16];
+    for (int c = 0; c < CANAIS; c++)
+    {
+        const meter_reading_t *canal = &leitura[c];
+        int y = c * 22;
+        if (c > 0)
+        {
+            ssd1306_hline(ssd, 0, WIDTH - 1, y - 2, true);
+        }
+        if (canal->estado == PROBE_OPEN || canal->estado == PROBE_SHORT)
+        {
+            snprintf(linha, sizeof(linha), "%d %s", c + 1, canal->estado == PROBE_OPEN ? "Aberto" : "Curto");
+            ssd1306_draw_string(ssd, linha, 0, y);
+            continue;
+        }
+        format_resistance_value(canal->r_x_mohm, valor, sizeof(valor));
+        snprintf(linha, sizeof(linha), "%d %s%s", c + 1, valor, canal->estado == PROBE_HOLD ? " H" : "");
+        ssd1306_draw_string(ssd, linha, 0, y);
+        if (canal->estado == PROBE_STABLE || canal->estado == PROBE_HOLD)
+        {
+            format_resistance_value(canal->closest_mohm, valor, sizeof(valor));
+            snprintf(linha, sizeof(linha), "  %s %s", e_series_tables[canal->series].name, valor);
+        }
+        else
+        {
+            snprintf(linha, sizeof(linha), "  Medindo...");
+        }
+        ssd1306_draw_string(ssd, linha, 0, y + 10);
+    }
+}
+
+// Desenha a tela completa no modo de exibição escolhido. `leitura` aponta
+// para as leituras de todos os canais; fora da varredura só a primeira conta.
+void render_tela(ssd1306_t *ssd, const meter_reading_t *leitura, uint8_t display_mode)
+{
+    char str_r_medido[16];    // Buffer para armazenar o valor medido
+    char str_r_comercial[16]; // Buffer para armazenar o valor comercial
+    int digits = leitura->digits;
+    int multiplier = leitura->multiplier;
+
+    // Formata as strings para exibição
+    format_resistance_value(leitura->r_x_mohm, str_r_medido, sizeof(str_r_medido));
+    format_resistance_value(leitura->closest_mohm, str_r_comercial, sizeof(str_r_comercial));
+
+    // Atualiza o conteúdo do display
+    ssd1306_fill(ssd, false); // Limpa o display
+
+    if (display_mode == MODO_CANAIS)
+    {
+        render_canais(ssd, leitura);
+        return;
+    }
+    if (display_mode == MODO_CONTINUIDADE)
+    {
+        render_continuidade(ssd);
+        return;
+    }
+    if (display_mode == MODO_SEPARACAO)
+    {
+        render_separacao(ssd, leitura);
+        return;
+    }
+    if (display_mode == MODO_TENDENCIA)
+    {
+        render_tendencia(ssd, leitura);
+        return;
+    }
+
+    // Ponta aberta ou em curto: nenhuma leitura para mostrar
+    if (leitura->estado == PROBE_OPEN || leitura->estado == PROBE_SHORT)
+    {
+        ssd1306_rect(ssd, 3, 3, 122, 60, true, false);
+        ssd1306_draw_string(ssd, leitura->estado == PROBE_OPEN ? "Ponta aberta" : "Curto", 16, 20);
+        ssd1306_draw_string(ssd, "Conecte o", 16, 36);
+        ssd1306_draw_string(ssd, "resistor", 16, 46);
+        return;
+    }
+
+    // Valor comercial e cores só depois de decididos
+    bool decidido = leitura->estado == PROBE_STABLE || leitura->estado == PROBE_HOLD;
+    if (!decidido)
+    {
+        snprintf(str_r_comercial, sizeof(str_r_comercial), "...");
+    }
+
+    if (display_mode == MODO_AVANCADO)
+    {
+        // Modo avançado - mostra o resistor com cores e detalhes
+        if (decidido)
+        {
+            draw_resistor_with_colors(ssd, leitura->bands, digits, multiplier);
+        }
+        else
+        {
+            ssd1306_draw_string(ssd, "Medindo...", 5, 22);
+        }
+
+        // Adiciona informações sobre valores
+        char str_incerteza[16];
+        format_resistance_value(leitura->incerteza_mohm, str_incerteza, sizeof(str_incerteza));
+        ssd1306_draw_string(ssd, leitura->estado == PROBE_HOLD ? "HOLD" : "+-", 5, 38); // Incerteza (99%) no lugar do título
+        ssd1306_draw_string(ssd, str_incerteza, 55, 38);
+        ssd1306_draw_string(ssd, "Medido:", 5, 48);                // Texto para valor medido
+        ssd1306_draw_string(ssd, str_r_medido, 55, 48);            // Valor medido
+        char str_serie[8];
+        sprintf(str_serie, "%s:", e_series_tables[leitura->series].name);
+        ssd1306_draw_string(ssd, str_serie, 5, 56);                 // Texto para valor comercial
+        ssd1306_draw_string(ssd, str_r_comercial, 55, 56);         // Valor comercial
+    }
+    else
+    {
+        // Modo simples - layout original com cores do resistor
+        ssd1306_rect(ssd, 3, 3, 122, 60, true, false); // Desenha um retângulo
+        // ssd1306_line(ssd, 3, 25, 123, 25, true);               // Desenha uma linha
+        ssd1306_line(ssd, 3, 37, 123, 37, true); // Desenha uma linha
+
+        // Substituir os textos originais pelos nomes das cores: uma linha por
+        // dígito e uma para o multiplicador (mais juntas nas séries de 3 dígitos)
+        char cor[16];
+        int passo = digits == 3 ? 8 : 10;
+        if (decidido)
+        {
+            for (int i = 0; i < digits; i++)
+            {
+                sprintf(cor, "%d:%s", i + 1, color_names[leitura->bands[i]]);
+                ssd1306_draw_string(ssd, cor, 8, 6 + passo * i);
+            }
+            sprintf(cor, "M:%s", color_names[multiplier]);
+            ssd1306_draw_string(ssd, cor, 8, 6 + passo * digits); // Multiplicador (abaixo dos dígitos)
+        }
+        else
+        {
+            ssd1306_draw_string(ssd, "Medindo...", 8, 16);
+        }
+
+        if (leitura->estado == PROBE_HOLD)
+        {
+            ssd1306_draw_string(ssd, "HOLD", 8, 41); // Leitura congelada
+        }
+        else
+        {
+            ssd1306_draw_string(ssd, "ADC", 13, 41); // Desenha uma string
+        }
+        ssd1306_draw_string(ssd, "Resisten.", 50, 41); // Desenha uma string
+        ssd1306_line(ssd, 44, 37, 44, 60, true);       // Desenha uma linha vertical
+
+        char str_x[12], str_y[16];
+        sprintf(str_x, "%lu", (unsigned long)((leitura->media_q8 + 128) >> 8)); // Código médio arredondado
+        sprintf(str_y, "%s", str_r_medido);      // Usa o valor formatado
+
+        ssd1306_draw_string(ssd, str_x, 8, 52);  // Desenha uma string
+        ssd1306_draw_string(ssd, str_y, 59, 52); // Desenha uma string
+    }
+}
+
+static scheduler_t *sched_core0;
+static ssd1306_t *oled;
+static int tarefa_render_id, tarefa_leds_id, tarefa_relatorio_id;
+static uint32_t periodo_render_ms = PERIODO_RENDER_MS; // DISPlay:PERiod pelo console
+static volatile uint8_t display_mode = CANAIS > 1 ? MODO_CANAIS : MODO_SIMPLES; // Modo de exibição (MODO_*)
+
+static meter_reading_t leituras[CANAIS]; // Os modos de um canal só mostram o primeiro
+static bool leitura_valida = false;
+static uint32_t ultima_versao[CANAIS];
+static volatile bool tela_pendente = false;
+
+// Tudo o que aparece na tela, já na resolução exibida: leituras novas que
+// não mudam nada visível não redesenham nem enviam quadro
+typedef struct
+{
+    uint32_t r_x, incerteza, comercial, codigo;
+    uint32_t contagem[BIN_COUNT - 1]; // Modo de separação
+    uint32_t canal_r[CANAIS], canal_comercial[CANAIS]; // Modo da varredura
+    uint8_t canal_estado[CANAIS];
+    int32_t desvio;
+    uint16_t pecas_min;
+    uint8_t estado, modo, series, classe;
+} tela_chave_t;
+
+static tela_chave_t chave_exibida;
+static bool chave_exibida_valida = false;
+static matriz_canal_t leds_exibidos[CANAIS];
+static uint8_t leds_exibidos_modo;
+static bool leds_exibidos_valido = false;
+
+// Valor como aparece em format_resistance_value (décimos de Ω ou centésimos de kΩ)
+static uint32_t valor_exibido(uint32_t r_mohm)
+{
+    return r_mohm < 1000000 ? (r_mohm + 50) / 100 : 0x80000000u | ((r_mohm + 5000) / 10000);
+}
+
+// `leitura` aponta para as leituras de todos os canais
+static void chave_da_tela(const meter_reading_t *leitura, uint8_t modo, tela_chave_t *chave)
+{
+    memset(chave, 0, sizeof(*chave)); // Sem lixo no preenchimento (memcmp)
+    chave->modo = modo;
+    if (modo == MODO_CONTINUIDADE)
+    {
+        meter_continuity_t continuidade = meter_continuity();
+        chave->estado = continuidade.closed;
+        chave->codigo = continuidade.delay_us / 100; // Resolução exibida (0,1 ms)
+        chave->r_x = continuidade.delay_max_us / 100;
+        return;
+    }
+    if (modo == MODO_CANAIS)
+    {
+        for (int c = 0; c < CANAIS; c++)
+        {
+            chave->canal_estado[c] = leitura[c].estado;
+            if (leitura[c].estado != PROBE_OPEN && leitura[c].estado != PROBE_SHORT)
+            {
+                chave->canal_r[c] = valor_exibido(leitura[c].r_x_mohm);
+                chave->canal_comercial[c] = leitura[c].closest_mohm;
+            }
+        }
+        chave->series = leitura[0].series;
+        return;
+    }
+    if (modo == MODO_TENDENCIA)
+    {
+        chave->codigo = tendencia.rescales; // Colunas novas vêm de tarefa_tendencia
+        return;
+    }
+    chave->estado = leitura->estado;
+    if (modo == MODO_SEPARACAO)
+    {
+        chave->series = leitura->series;
+        chave->comercial = leitura->nominal_mohm;
+        memcpy(chave->contagem, leitura->contagem, sizeof(chave->contagem));
+        chave->pecas_min = leitura->pecas_min;
+        if (leitura->estado == PROBE_STABLE || leitura->estado == PROBE_HOLD)
+        {
+            chave->classe = leitura->classe;
+            chave->desvio = (leitura->desvio_ppm + (leitura->desvio_ppm < 0 ? -500 : 500)) / 1000;
+        }
+        return;
+    }
+    if (leitura->estado == PROBE_OPEN || leitura->estado == PROBE_SHORT)
+    {
+        return;
+    }
+    chave->series = leitura->series;
+    chave->r_x = valor_exibido(leitura->r_x_mohm);
+    chave->comercial = leitura->closest_mohm;
+    if (modo == MODO_AVANCADO)
+    {
+        chave->incerteza = valor_exibido(leitura->incerteza_mohm);
+    }
+    else
+    {
+        chave->codigo = (leitura->media_q8 + 128) >> 8;
+    }
+}
+
+// Latência entre o toque no botão e o fim do envio do primeiro quadro
+// desenhado depois dele (um envio já em andamento no toque não conta)
+static volatile uint64_t t_botao_us = 0;        // Toque ainda sem quadro desenhado
+static volatile uint64_t t_botao_quadro_us = 0; // Toque cujo quadro está sendo enviado
+static volatile uint32_t quadro_botao;          // frames_sent ao fim desse envio
+static volatile uint32_t latencia_botao_us = 0;
+
+// Modo de exibição e os modos de medição que dependem dele (separação e
+// continuidade rodam no core 1)
+void interface_define_modo(uint8_t modo)
+{
+    display_mode = modo;
+    meter_set_binning(modo == MODO_SEPARACAO);
+    meter_set_continuity(modo == MODO_CONTINUIDADE);
+    meter_set_display_mode(modo);
+}
+
+uint8_t interface_modo(void)
+{
+    return display_mode;
+}
+
+// Botão A alterna o modo de exibição (simples -> avançado -> separação ->
+// tendência) e pede um novo quadro imediatamente
+void botao_a_handler(uint gpio, uint32_t events, uint64_t timestamp_us)
+{
+    interface_define_modo((display_mode + 1) % MODO_COUNT);
+    meter_touch(TELEMETRY_EVENT_BUTTON_A, display_mode, timestamp_us);
+    tela_pendente = true;
+    t_botao_us = timestamp_us;
+    sched_post(sched_core0, tarefa_render_id);
+}
+
+// Botão do joystick seleciona a próxima série E (E6 -> ... -> E192 -> E6)
+void botao_joy_handler(uint gpio, uint32_t events, uint64_t timestamp_us)
+{
+    uint8_t serie = (meter_series() + 1) % E_SERIES_COUNT;
+    meter_set_series(serie);
+    meter_touch(TELEMETRY_EVENT_BUTTON_JOY, serie, timestamp_us);
+}
+
+// Chamado no IRQ do I2C quando um quadro termina de ser enviado
+static void display_enviado(ssd1306_t *display)
+{
+    PROF_RECORD_US(PROF_I2C_FLUSH, display->transfer_us);
+    if (tela_pendente)
+    {
+        sched_post(sched_core0, tarefa_render_id);
+    }
+    if (t_botao_quadro_us && display->frames_sent == quadro_botao)
+    {
+        latencia_botao_us = time_us_64() - t_botao_quadro_us;
+        t_botao_quadro_us = 0;
+        sched_post(sched_core0, tarefa_relatorio_id);
+    }
+}
+
+// Um ponto do gráfico de tendência a cada TENDENCIA_PONTO_MS, mesmo fora do
+// modo (o histórico já está pronto ao entrar). No modo, só a coluna nova, o
+// cursor e o cabeçalho são desenhados, e o envio leva só essas colunas; uma
+// mudança de escala pede o redesenho completo a tarefa_render.
+static void tarefa_tendencia(void *ctx)
+{
+    meter_reading_t leitura;
+    meter_read(0, &leitura);
+    bool peca = leitura.estado == PROBE_SETTLING || leitura.estado == PROBE_STABLE;
+    uint32_t r = peca ? leitura.r_x_mohm : 0;
+    bool reescala = trend_push(&tendencia, r);
+    if (display_mode != MODO_TENDENCIA || !chave_exibida_valida || chave_exibida.modo != MODO_TENDENCIA)
+    {
+        return;
+    }
+    if (reescala)
+    {
+        tela_pendente = true;
+        sched_post(sched_core0, tarefa_render_id);
+        return;
+    }
+    render_tendencia_coluna(oled, (tendencia.count - 1) % TREND_POINTS);
+    render_tendencia_cursor(oled);
+    render_tendencia_cabecalho(oled, r);
+    ssd1306_present(oled); // Ocupado: as colunas marcadas vão no próximo envio
+}
+
+// Redesenha quando há leitura nova ou troca de modo
+static void tarefa_render(void *ctx)
+{
+    for (int c = 0; c < CANAIS; c++)
+    {
+        if (meter_version(c) != ultima_versao[c])
+        {
+            ultima_versao[c] = meter_read(c, &leituras[c]);
+            leitura_valida = true;
+            tela_pendente = true;
+        }
+    }
+    // Só depois de decidida: uma peça já na ponta no boot publica antes
+    // leituras acomodando
+    static bool boot_informado = false;
+    if (!boot_informado && meter_first_reading_us())
+    {
+        printf("Boot: primeira leitura em %lu us\n", (unsigned long)meter_first_reading_us());
+        boot_informado = true;
+    }
+    if (display_mode == MODO_CONTINUIDADE)
+    {
+        // O bipe e a matriz já deram a resposta; a tela acompanha sem pressa
+        // e o envio pelo I2C nunca disputa com o caminho rápido
+        static uint64_t ultima_tela_us = 0;
+        uint64_t agora = time_us_64();
+        if (agora - ultima_tela_us < PERIODO_TELA_CONTINUIDADE_MS * 1000)
+        {
+            return;
+        }
+        ultima_tela_us = agora;
+        tela_pendente = true;
+    }
+    if (!leitura_valida || !tela_pendente)
+    {
+        return;
+    }
+
+    // Mesmo conteúdo que já está na tela: nem desenha nem envia
+    tela_chave_t chave;
+    chave_da_tela(leituras, display_mode, &chave);
+    if (chave_exibida_valida && memcmp(&chave, &chave_exibida, sizeof(chave)) == 0)
+    {
+        tela_pendente = false;
+        return;
+    }
+    if (ssd1306_busy(oled))
+    {
+        return; // display_enviado() pede outra execução no fim do envio
+    }
+    tela_pendente = false;
+    chave_exibida = chave;
+    chave_exibida_valida = true;
+    uint32_t status = save_and_disable_interrupts(); // O toque chega pelo IRQ do GPIO
+    uint64_t toque = t_botao_us;
+    t_botao_us = 0;
+    restore_interrupts(status);
+    PROF_START(t_render);
+    render_tela(oled, leituras, display_mode);
+    PROF_END(PROF_RENDER, t_render);
+    if (toque)
+    {
+        // Display livre: o próximo envio concluído é este quadro
+        quadro_botao = oled->frames_sent + 1;
+        t_botao_quadro_us = toque;
+    }
+    ssd1306_present(oled); // Atualiza o display (envio por DMA, sem bloquear)
+    if (toque && t_botao_quadro_us && !ssd1306_busy(oled))
+    {
+        // Nada mudou na tela: o toque já está visível
+        t_botao_quadro_us = 0;
+        latencia_botao_us = time_us_64() - toque;
+        sched_post(sched_core0, tarefa_relatorio_id);
+    }
+}
+
+// Atualiza a matriz de LEDs só quando as faixas (ou, na separação, o
+// resultado da peça) mudam; sem valor decidido (aberto, curto ou
+// estabilizando) a matriz fica apagada. Na varredura cada canal tem a sua
+// linha.
+static void tarefa_leds(void *ctx)
+{
+    if (!leitura_valida)
+    {
+        return; // A animação de inicialização continua rodando
+    }
+    if (led_anim_running())
+    {
+        led_anim_stop(); // A matriz passa a mostrar as leituras
+    }
+    uint8_t modo = display_mode;
+    static uint32_t periodo_us = PERIODO_LEDS_MS * 1000;
+    uint32_t periodo_modo_us = modo == MODO_CONTINUIDADE ? PERIODO_LEDS_CONTINUIDADE_US : PERIODO_LEDS_MS * 1000;
+    if (periodo_modo_us != periodo_us)
+    {
+        periodo_us = periodo_modo_us;
+        sched_set_period(sched_core0, tarefa_leds_id, periodo_us);
+    }
+    if (modo == MODO_CONTINUIDADE)
+    {
+        // Matriz toda verde (continuidade) ou vermelha; quadros iguais ao
+        // anterior são descartados por write_leds_async
+        bool fechada = meter_continuity().closed;
+        set_all_leds(fechada ? 0 : 40, fechada ? 40 : 0, 0);
+        if (write_leds_async())
+        {
+            leds_exibidos_modo = modo;
+        }
+        return;
+    }
+    matriz_canal_t leds[CANAIS];
+    memset(leds, 0, sizeof(leds));
+    for (int c = 0; c < (modo == MODO_CANAIS ? CANAIS : 1); c++)
+    {
+        const meter_reading_t *leitura = &leituras[c];
+        if (leitura->estado != PROBE_STABLE && leitura->estado != PROBE_HOLD)
+        {
+            continue;
+        }
+        if (modo == MODO_SEPARACAO)
+        {
+            leds[c].classe = leitura->classe;
+        }
+        else
+        {
+            leds[c].digits = leitura->digits;
+            leds[c].multiplier = leitura->multiplier;
+            memcpy(leds[c].bands, leitura->bands, sizeof(leds[c].bands));
+        }
+    }
+    // Outro modo pode desenhar as mesmas faixas de outro jeito
+    if (leds_exibidos_valido && modo == leds_exibidos_modo && memcmp(leds, leds_exibidos, sizeof(leds)) == 0)
+    {
+        return;
+    }
+    PROF_START(t_leds);
+    bool enviado;
+    if (modo == MODO_CANAIS)
+    {
+        enviado = display_channels_on_matrix(leds);
+    }
+    else if (leds[0].classe != BIN_NONE)
+    {
+        enviado = display_class_on_matrix(leds[0].classe);
+    }
+    else if (leds[0].digits)
+    {
+        enviado = display_resistor_colors_on_matrix(leds[0].bands, leds[0].digits, leds[0].multiplier);
+    }
+    else
+    {
+        clear_leds();
+        enviado = write_leds_async();
+    }
+    PROF_END(PROF_LED_FLUSH, t_leds);
+    if (enviado) // Ocupada: tenta de novo no próximo período
+    {
+        memcpy(leds_exibidos, leds, sizeof(leds));
+        leds_exibidos_modo = modo;
+        leds_exibidos_valido = true;
+    }
+}
+
+static void tarefa_relatorio(void *ctx)
+{
+    printf("Latencia botao->display: %lu us\n", (unsigned long)latencia_botao_us);
+}
+
+// Tarefas da interface. A renderização também é disparada pelo botão A e
+// pelo fim de cada envio do display.
+void interface_inicia(scheduler_t *sched, ssd1306_t *ssd)
+{
+    sched_core0 = sched;
+    oled = ssd;
+    interface_define_modo(display_mode);
+    tarefa_render_id = sched_add(sched, "render", tarefa_render, NULL, periodo_render_ms * 1000);
+    tarefa_leds_id = sched_add(sched, "leds", tarefa_leds, NULL, PERIODO_LEDS_MS * 1000);
+    sched_add(sched, "tendencia", tarefa_tendencia, NULL, TENDENCIA_PONTO_MS * 1000);
+    tarefa_relatorio_id = sched_add(sched, "relatorio", tarefa_relatorio, NULL, 0);
+    ssd1306_set_callback(ssd, display_enviado);
+}
+
+void interface_define_periodo_render(uint32_t ms)
+{
+    periodo_render_ms = ms;
+    sched_set_period(sched_core0, tarefa_render_id, ms * 1000);
+}
+
+uint32_t interface_periodo_render(void)
+{
+    return periodo_render_ms;
+}
+
+const meter_reading_t *interface_leituras(void)
+{
+    return leituras;
+}
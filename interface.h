@@ -0,0 +1,38 @@
+#ifndef INTERFACE_H
+#define INTERFACE_H
+
+#include "pico/stdlib.h"
+#include "lib/meter.h"
+#include "lib/scheduler.h"
+#include "lib/ssd1306.h"
+
+// Core 0: interface (display, matriz de LEDs e botões A e do joystick). As
+// tarefas leem as leituras publicadas pelo core 1 (lib/meter.c) e só
+// redesenham o que muda na tela ou na matriz.
+
+#define PERIODO_RENDER_MS 50       // Verificação de leitura nova para a tela
+#define MODO_SIMPLES 0             // Modos de exibição (botão A alterna)
+#define MODO_AVANCADO 1
+#define MODO_SEPARACAO 2           // Separação de peças por valor
+#define MODO_TENDENCIA 3           // Gráfico de R_x ao longo do tempo
+#define MODO_CONTINUIDADE 4        // Teste de continuidade com bipe
+#define MODO_CANAIS 5              // Todos os canais da varredura
+#define MODO_COUNT (CANAIS > 1 ? 6 : 5)
+
+// Adiciona as tarefas da interface a `sched` e assume o display
+void interface_inicia(scheduler_t *sched, ssd1306_t *ssd);
+
+void interface_define_modo(uint8_t modo);
+uint8_t interface_modo(void);
+void interface_define_periodo_render(uint32_t ms);
+uint32_t interface_periodo_render(void);
+// Leituras mostradas agora, uma por canal
+const meter_reading_t *interface_leituras(void);
+// Desenha no framebuffer a tela inteira de um modo (sem enviar); fora da
+// varredura só a primeira leitura conta
+void render_tela(ssd1306_t *ssd, const meter_reading_t *leituras, uint8_t modo);
+
+void botao_a_handler(uint gpio, uint32_t events, uint64_t timestamp_us);
+void botao_joy_handler(uint gpio, uint32_t events, uint64_t timestamp_us);
+
+#endif
@@ -0,0 +1,143 @@
+#include "adc_cal.h"
+#include <stddef.h>
+#include <string.h>
+#include "pico/platform.h"
+
+static uint32_t crc32(const uint8_t *data, size_t n) {
+    uint32_t crc = 0xFFFFFFFFu;
+    while (n--) {
+        crc ^= *data++;
+        for (int k = 0; k < 8; k++)
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+    }
+    return ~crc;
+}
+
+// ADC ideal, sem offset
+void adc_cal_defaults(adc_cal_t *cal, uint32_t r_known_mohm) {
+    memset(cal, 0, sizeof(*cal));
+    cal->magic = ADC_CAL_MAGIC;
+    cal->version = ADC_CAL_VERSION;
+    for (int i = 0; i < ADC_CAL_CHANNELS; i++)
+        cal->r_known_mohm[i] = r_known_mohm;
+    for (uint32_t c = 0; c < ADC_CAL_CODES; c++)
+        cal->center_q4[c] = c << 4;
+    adc_cal_seal(cal);
+}
+
+void adc_cal_seal(adc_cal_t *cal) {
+    cal->crc = crc32((const uint8_t *)cal, offsetof(adc_cal_t, crc));
+}
+
+bool adc_cal_valid(const adc_cal_t *cal) {
+    if (cal->magic != ADC_CAL_MAGIC || cal->version != ADC_CAL_VERSION)
+        return false;
+    for (int i = 0; i < ADC_CAL_CHANNELS; i++) {
+        if (cal->r_known_mohm[i] == 0)
+            return false;
+    }
+    return cal->crc == crc32((const uint8_t *)cal, offsetof(adc_cal_t, crc));
+}
+
+// Tabela aplicada por amostra: centro do código menos o offset, limitada a >= 0
+void adc_cal_build_table(const adc_cal_t *cal, uint16_t *table_q4) {
+    for (uint32_t c = 0; c < ADC_CAL_CODES; c++) {
+        int32_t v = (int32_t)cal->center_q4[c] - cal->offset_q4;
+        table_q4[c] = v < 0 ? 0 : v > 0xFFFF ? 0xFFFF : (uint16_t)v;
+    }
+}
+
+// Laços por amostra das capturas, chamados no IRQ do bloco: ficam na SRAM
+void __not_in_flash_func(adc_cal_hist_add)(uint32_t *hist, const uint16_t *samples, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++)
+        hist[samples[i] & 0x0FFF]++;
+}
+
+uint64_t __not_in_flash_func(adc_cal_sum_q4)(const uint16_t *table_q4, const uint16_t *samples, uint32_t count) {
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < count; i++)
+        sum += table_q4[samples[i] & 0x0FFF];
+    return sum;
+}
+
+// Largura do código c (Q16): ocorrências dele sobre a média da vizinhança,
+// o que tolera uma varredura manual de velocidade irregular; 0 se a
+// vizinhança tem poucas ocorrências
+static uint32_t code_width_q16(const uint32_t *hist, int32_t c) {
+    const int32_t n = ADC_CAL_NEIGHBORS;
+    uint64_t local = 0;
+    for (int32_t k = c - n; k <= c + n; k++)
+        local += hist[k];
+    if (local < (uint64_t)ADC_CAL_MIN_HITS * (2 * n + 1))
+        return 0;
+    return (uint32_t)(((uint64_t)hist[c] * (2 * n + 1) << 16) / local);
+}
+
+// Teste de densidade de códigos no maior trecho contínuo bem varrido. O
+// centro de cada código é a soma das larguras anteriores mais metade da
+// sua; a reta de mínimos quadrados desse desvio em relação ao código ideal
+// é removida, então a tabela corrige só a não linearidade (ganho não importa
+// no divisor ratiométrico e o offset é calibrado à parte).
+bool adc_cal_linearize(adc_cal_t *cal, const uint32_t *hist) {
+    const int32_t n = ADC_CAL_NEIGHBORS;
+    int32_t first = -1, last = -1;
+    for (int32_t c = n, start = -1; c <= ADC_CAL_CODES - n; c++) {
+        bool ok = c < ADC_CAL_CODES - n && code_width_q16(hist, c) > 0;
+        if (ok && start < 0)
+            start = c;
+        if (!ok && start >= 0) {
+            if (c - 1 - start > last - first) {
+                first = start;
+                last = c - 1;
+            }
+            start = -1;
+        }
+    }
+    // As bordas da varredura têm densidade caindo: descarta uma vizinhança
+    first += n;
+    last -= n;
+    if (last - first < 4 * n)
+        return false;
+
+    // Desvio d = centro - código (Q16) e a reta d = a * x + b, x = c - first
+    int64_t sx = 0, sy = 0, sxx = 0, sxy = 0, cnt = last - first + 1;
+    int64_t edge_q16 = 0;
+    for (int32_t c = first; c <= last; c++) {
+        uint32_t w = code_width_q16(hist, c);
+        int64_t x = c - first;
+        int64_t d = edge_q16 + w / 2 - (x << 16) - (1 << 15);
+        sx += x;
+        sy += d;
+        sxx += x * x;
+        sxy += x * d;
+        edge_q16 += w;
+    }
+    int64_t den = cnt * sxx - sx * sx;
+    int64_t a_num = cnt * sxy - sx * sy; // a = a_num / den
+    int64_t b_num = sy * sxx - sx * sxy; // b = b_num / den
+
+    edge_q16 = 0;
+    for (int32_t c = 0; c < ADC_CAL_CODES; c++) {
+        if (c < first || c > last) {
+            cal->center_q4[c] = c << 4;
+            continue;
+        }
+        uint32_t w = code_width_q16(hist, c);
+        int64_t x = c - first;
+        int64_t d = edge_q16 + w / 2 - (x << 16) - (1 << 15);
+        int64_t center_q16 = ((int64_t)c << 16) + d - (a_num * x + b_num) / den;
+        cal->center_q4[c] = center_q16 <= 0 ? 0 : (uint16_t)((center_q16 + (1 << 11)) >> 12);
+        edge_q16 += w;
+    }
+    cal->lin_first = first;
+    cal->lin_last = last;
+    return true;
+}
+
+// Inverso do divisor: com R_ref na ponta, R_conhecido = R_ref * (4095 - m) / m
+uint32_t adc_cal_r_known_mohm(uint32_t mean_q4, uint32_t r_ref_mohm) {
+    const uint32_t full_q4 = 4095u << 4;
+    if (mean_q4 == 0 || mean_q4 >= full_q4)
+        return 0;
+    return (uint32_t)(((uint64_t)r_ref_mohm * (full_q4 - mean_q4) + mean_q4 / 2) / mean_q4);
+}
@@ -0,0 +1,51 @@
+#ifndef ADC_CAL_H
+#define ADC_CAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Calibração por unidade: linearidade do ADC, offset e resistor conhecido
+//
+// O ADC do RP2040 tem códigos muito largos/estreitos (DNL) perto de
+// 512/1536/2560/3584. A linearização vem de um teste de densidade de
+// códigos: com uma varredura lenta da entrada (potenciômetro na ponta), a
+// frequência de cada código, normalizada pela vizinhança de ±16 códigos, é a
+// largura dele; o centro real de cada código sai da soma das larguras,
+// ancorada nas pontas da faixa varrida. O offset vem da ponta em curto e o
+// resistor conhecido (um por canal) de uma referência de precisão na ponta.
+//
+// O registro (com CRC-32) é gravado como está na flash; a tabela aplicada
+// por amostra (adc_cal_build_table) já desconta o offset.
+
+#define ADC_CAL_CODES 4096
+#define ADC_CAL_MAGIC 0x4C41434Fu   // "OCAL"
+#define ADC_CAL_VERSION 2
+#define ADC_CAL_CHANNELS 3          // Divisores em varredura (GPIO 26 a 28)
+#define ADC_CAL_NEIGHBORS 16        // Vizinhança da normalização (±)
+#define ADC_CAL_MIN_HITS 64         // Ocorrências médias por código para confiar na largura
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t lin_first, lin_last;   // Faixa linearizada (identidade fora dela)
+    uint16_t reserved;
+    uint32_t r_known_mohm[ADC_CAL_CHANNELS]; // Resistor conhecido medido, por canal
+    int32_t offset_q4;              // Código lido com a ponta em curto (Q4)
+    uint16_t center_q4[ADC_CAL_CODES]; // Centro real de cada código (Q4)
+    uint32_t crc;                   // CRC-32 de tudo acima
+} adc_cal_t;
+
+void adc_cal_defaults(adc_cal_t *cal, uint32_t r_known_mohm);
+void adc_cal_seal(adc_cal_t *cal);
+bool adc_cal_valid(const adc_cal_t *cal);
+void adc_cal_build_table(const adc_cal_t *cal, uint16_t *table_q4);
+
+// Captura (chamadas por bloco, no IRQ do DMA)
+void adc_cal_hist_add(uint32_t *hist, const uint16_t *samples, uint32_t count);
+uint64_t adc_cal_sum_q4(const uint16_t *table_q4, const uint16_t *samples, uint32_t count);
+
+// Resultado das capturas
+bool adc_cal_linearize(adc_cal_t *cal, const uint32_t *hist);
+uint32_t adc_cal_r_known_mohm(uint32_t mean_q4, uint32_t r_ref_mohm);
+
+#endif
@@ -0,0 +1,156 @@
+#include "adc_dma.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+// Buffer ping-pong: cada canal de DMA escreve em uma metade
+static uint16_t adc_buffer[2][ADC_DMA_BLOCK_SAMPLES] __attribute__((aligned(4)));
+static int dma_chan[2] = {-1, -1};
+static uint adc_input;
+static uint adc_round_robin = 0; // Máscara das entradas em varredura (0 = só adc_input)
+
+static adc_dma_callback_t block_callback = NULL;
+static adc_block_t last_block;
+static volatile bool block_ready = false;
+static volatile uint32_t block_seq = 0;
+static volatile uint32_t overrun_count = 0;
+
+// Rearma o canal que terminou e entrega o bloco preenchido por ele. O caminho
+// do IRQ (handler, entrega e decimação) roda da SRAM: uma falta no cache do
+// XIP custa dezenas de ciclos e o core 0 disputa a flash com o display.
+static void __not_in_flash_func(adc_dma_irq_handler)(void) {
+    for (int i = 0; i < 2; i++) {
+        if (dma_chan[i] >= 0 && dma_channel_get_irq0_status(dma_chan[i])) {
+            dma_channel_acknowledge_irq0(dma_chan[i]);
+            // O canal só volta a rodar quando o outro terminar (chain_to)
+            dma_channel_set_write_addr(dma_chan[i], adc_buffer[i], false);
+            dma_channel_set_trans_count(dma_chan[i], ADC_DMA_BLOCK_SAMPLES, false);
+            adc_dma_deliver(adc_buffer[i], ADC_DMA_BLOCK_SAMPLES);
+        }
+    }
+}
+
+static void adc_dma_configure_channel(int i) {
+    dma_channel_config c = dma_channel_get_default_config(dma_chan[i]);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);  // Sempre lê da FIFO do ADC
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, DREQ_ADC);
+    channel_config_set_chain_to(&c, dma_chan[i ^ 1]);
+    dma_channel_configure(dma_chan[i], &c, adc_buffer[i], &adc_hw->fifo, ADC_DMA_BLOCK_SAMPLES, false);
+    dma_channel_set_irq0_enabled(dma_chan[i], true);
+}
+
+void adc_dma_init(uint input, uint32_t sample_rate_hz) {
+    adc_input = input;
+    adc_init();
+    adc_gpio_init(26 + input);
+    adc_select_input(input);
+    // FIFO habilitada, DREQ a cada amostra, sem bit de erro, 12 bits sem deslocamento
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_dma_set_rate(sample_rate_hz);
+
+    dma_chan[0] = dma_claim_unused_channel(true);
+    dma_chan[1] = dma_claim_unused_channel(true);
+    adc_dma_configure_channel(0);
+    adc_dma_configure_channel(1);
+
+    irq_add_shared_handler(DMA_IRQ_0, adc_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
+// Varredura de `count` entradas consecutivas a partir de `first_input`
+void adc_dma_set_inputs(uint first_input, uint count) {
+    adc_input = first_input;
+    for (uint i = 0; i < count; i++)
+        adc_gpio_init(26 + first_input + i);
+    adc_round_robin = count > 1 ? ((1u << count) - 1) << first_input : 0;
+}
+
+// Período de amostragem = (1 + div) ciclos de clk_adc, mínimo de 96 ciclos
+void adc_dma_set_rate(uint32_t sample_rate_hz) {
+    if (sample_rate_hz == 0 || sample_rate_hz > ADC_DMA_MAX_RATE_HZ)
+        sample_rate_hz = ADC_DMA_MAX_RATE_HZ;
+    adc_set_clkdiv((float)ADC_DMA_CLOCK_HZ / sample_rate_hz - 1.0f);
+}
+
+void adc_dma_set_callback(adc_dma_callback_t callback) {
+    block_callback = callback;
+}
+
+void adc_dma_start(void) {
+    adc_select_input(adc_input); // A varredura sempre começa pela primeira entrada
+    adc_set_round_robin(adc_round_robin);
+    adc_fifo_drain();
+    block_ready = false;
+    dma_channel_set_write_addr(dma_chan[1], adc_buffer[1], false);
+    dma_channel_set_write_addr(dma_chan[0], adc_buffer[0], true);
+    adc_run(true);
+}
+
+void adc_dma_stop(void) {
+    adc_run(false);
+    // Desabilita o IRQ antes do abort para não receber uma conclusão espúria
+    dma_channel_set_irq0_enabled(dma_chan[0], false);
+    dma_channel_set_irq0_enabled(dma_chan[1], false);
+    dma_channel_abort(dma_chan[0]);
+    dma_channel_abort(dma_chan[1]);
+    dma_channel_acknowledge_irq0(dma_chan[0]);
+    dma_channel_acknowledge_irq0(dma_chan[1]);
+    dma_channel_set_irq0_enabled(dma_chan[0], true);
+    dma_channel_set_irq0_enabled(dma_chan[1], true);
+    adc_fifo_drain();
+}
+
+bool adc_dma_block_ready(void) {
+    return block_ready;
+}
+
+// Copia o último bloco entregue; retorna false se não houver bloco novo
+bool adc_dma_read_block(adc_block_t *block) {
+    if (!block_ready)
+        return false;
+    uint32_t status = save_and_disable_interrupts();
+    *block = last_block;
+    block_ready = false;
+    restore_interrupts(status);
+    return true;
+}
+
+uint32_t adc_dma_overruns(void) {
+    return overrun_count;
+}
+
+// Entrega de um bloco completo (chamada pelo IRQ ou por uma fonte simulada)
+void __not_in_flash_func(adc_dma_deliver)(const uint16_t *samples, uint count) {
+    adc_block_t block;
+    adc_dma_reduce(samples, count, &block);
+    block.seq = ++block_seq;
+    if (block_ready)
+        overrun_count++; // O bloco anterior não foi consumido
+    last_block = block;
+    block_ready = true;
+    if (block_callback)
+        block_callback(samples, count);
+}
+
+// Decimação do bloco inteiro em soma/mínimo/máximo
+void __not_in_flash_func(adc_dma_reduce)(const uint16_t *samples, uint count, adc_block_t *block) {
+    uint32_t sum = 0;
+    uint64_t sum_sq = 0;
+    uint16_t min = 0x0FFF, max = 0;
+    for (uint i = 0; i < count; i++) {
+        uint16_t s = samples[i] & 0x0FFF;
+        sum += s;
+        sum_sq += (uint32_t)s * s;
+        if (s < min) min = s;
+        if (s > max) max = s;
+    }
+    block->sum = sum;
+    block->sum_sq = sum_sq;
+    block->count = count;
+    block->min = count ? min : 0;
+    block->max = max;
+    block->seq = 0;
+}
+
@@ -0,0 +1,44 @@
+#ifndef ADC_DMA_H
+#define ADC_DMA_H
+
+#include "pico/stdlib.h"
+
+// Aquisição contínua do ADC em modo free-running (FIFO + DMA)
+//
+// Dois canais de DMA encadeados (ping-pong) preenchem alternadamente as duas
+// metades de um buffer. Ao final de cada metade o IRQ de DMA entrega o bloco:
+// calcula a soma das amostras (decimação por média) e chama o callback, se houver.
+// Com várias entradas em varredura (round-robin) as amostras chegam
+// intercaladas, começando pela primeira entrada, na mesma taxa total.
+
+#define ADC_DMA_BLOCK_SAMPLES 256      // Amostras por bloco (granularidade das leituras)
+#define ADC_DMA_CLOCK_HZ 48000000u     // Clock do ADC (clk_adc)
+#define ADC_DMA_MAX_RATE_HZ 500000u    // Taxa máxima do ADC do RP2040 (96 ciclos)
+
+// Resultado de um bloco já decimado
+typedef struct {
+    uint32_t sum;       // Soma das amostras do bloco
+    uint64_t sum_sq;    // Soma dos quadrados (variância do bloco)
+    uint16_t count;     // Número de amostras somadas
+    uint16_t min, max;  // Extremos do bloco (indicam ruído/contato ruim)
+    uint32_t seq;       // Número de sequência do bloco
+} adc_block_t;
+
+// Callback chamado no contexto do IRQ de DMA a cada bloco completo
+typedef void (*adc_dma_callback_t)(const uint16_t *samples, uint count);
+
+void adc_dma_init(uint input, uint32_t sample_rate_hz);
+void adc_dma_set_inputs(uint first_input, uint count);
+void adc_dma_set_rate(uint32_t sample_rate_hz);
+void adc_dma_set_callback(adc_dma_callback_t callback);
+void adc_dma_start(void);
+void adc_dma_stop(void);
+bool adc_dma_block_ready(void);
+bool adc_dma_read_block(adc_block_t *block);
+uint32_t adc_dma_overruns(void);
+
+// Lógica de entrega/decimação, independente do hardware
+void adc_dma_deliver(const uint16_t *samples, uint count);
+void adc_dma_reduce(const uint16_t *samples, uint count, adc_block_t *block);
+
+#endif
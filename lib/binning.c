@@ -0,0 +1,82 @@
+#include "binning.h"
+#include <string.h>
+
+void binning_init(binning_t *b, uint32_t nominal_mohm, uint16_t tolerance_tenths) {
+    memset(b, 0, sizeof(*b));
+    b->nominal_mohm = nominal_mohm;
+    b->tolerance_tenths = tolerance_tenths;
+    b->armed = true;
+}
+
+// Desvio relativo ao nominal; acima de 1,5x a tolerância só é "valor errado"
+// se o valor comercial mais próximo também for outro (senão é alto/baixo)
+bin_class_t binning_classify(const binning_t *b, uint32_t r_mohm, uint32_t closest_mohm, int32_t *dev_ppm) {
+    int64_t diff = (int64_t)r_mohm - b->nominal_mohm;
+    int32_t dev = (int32_t)(diff * 1000000 / b->nominal_mohm);
+    int32_t tol = (int32_t)b->tolerance_tenths * 1000;
+    int32_t mag = dev < 0 ? -dev : dev;
+    *dev_ppm = dev;
+    if (mag <= tol)
+        return BIN_PASS;
+    if (closest_mohm != b->nominal_mohm && mag > tol + tol / 2)
+        return BIN_WRONG;
+    return dev > 0 ? BIN_HIGH : BIN_LOW;
+}
+
+void binning_removed(binning_t *b) {
+    b->armed = true;
+}
+
+static void binning_histogram(binning_t *b, int32_t dev_ppm) {
+    // Divisão arredondando para baixo também nos negativos
+    int32_t step = dev_ppm >= 0 ? dev_ppm / BINNING_HIST_STEP_PPM : -((-dev_ppm + BINNING_HIST_STEP_PPM - 1) / BINNING_HIST_STEP_PPM);
+    int32_t i = step + BINNING_HIST_BINS / 2;
+    if (i < 0)
+        i = 0;
+    if (i >= BINNING_HIST_BINS)
+        i = BINNING_HIST_BINS - 1;
+    if (b->hist[i] < UINT16_MAX)
+        b->hist[i]++;
+}
+
+// Classifica uma leitura estável; BIN_NONE se esta peça já foi contada
+bin_class_t binning_part(binning_t *b, uint32_t r_mohm, uint32_t closest_mohm, uint64_t now_us) {
+    if (!b->armed)
+        return BIN_NONE;
+    b->armed = false;
+    if (b->nominal_mohm == 0)
+        b->nominal_mohm = closest_mohm; // Peça padrão ensina o alvo
+
+    int32_t dev;
+    bin_class_t c = binning_classify(b, r_mohm, closest_mohm, &dev);
+    b->last = c;
+    b->last_dev_ppm = dev;
+    b->counts[c]++;
+    binning_histogram(b, dev);
+
+    if (b->times_count && now_us - b->times_us[(b->times_head + BINNING_RATE_WINDOW - 1) % BINNING_RATE_WINDOW] > BINNING_IDLE_US)
+        b->times_count = 0;
+    b->times_us[b->times_head] = now_us;
+    b->times_head = (b->times_head + 1) % BINNING_RATE_WINDOW;
+    if (b->times_count < BINNING_RATE_WINDOW)
+        b->times_count++;
+    return c;
+}
+
+uint32_t binning_total(const binning_t *b) {
+    uint32_t total = 0;
+    for (int i = BIN_PASS; i < BIN_COUNT; i++)
+        total += b->counts[i];
+    return total;
+}
+
+// Ritmo entre a mais antiga e a mais nova das últimas peças; zero se parado
+uint32_t binning_parts_per_minute(const binning_t *b, uint64_t now_us) {
+    if (b->times_count < 2)
+        return 0;
+    uint64_t newest = b->times_us[(b->times_head + BINNING_RATE_WINDOW - 1) % BINNING_RATE_WINDOW];
+    uint64_t oldest = b->times_us[(b->times_head + BINNING_RATE_WINDOW - b->times_count) % BINNING_RATE_WINDOW];
+    if (now_us - newest > BINNING_IDLE_US || newest == oldest)
+        return 0;
+    return (uint32_t)((uint64_t)(b->times_count - 1) * 60000000u / (newest - oldest));
+}
@@ -0,0 +1,49 @@
+#ifndef BINNING_H
+#define BINNING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Separação de peças em produção: cada peça inserida é classificada uma
+// única vez contra um valor nominal e uma tolerância
+//
+// A peça é contada na primeira leitura estável depois de uma retirada
+// (binning_removed), então degraus e trepidação com a peça no lugar não
+// contam duas vezes. Sem nominal definido, a primeira peça ensina o alvo
+// (o valor comercial mais próximo dela). Desvio e histograma em ppm e
+// passos de BINNING_HIST_STEP_PPM, só com inteiros.
+
+typedef enum {
+    BIN_NONE,   // Nenhuma peça classificada
+    BIN_PASS,   // Dentro da tolerância
+    BIN_HIGH,   // Acima da tolerância
+    BIN_LOW,    // Abaixo da tolerância
+    BIN_WRONG,  // Outro valor comercial, mais de 1,5x a tolerância
+    BIN_COUNT
+} bin_class_t;
+
+#define BINNING_HIST_BINS 32
+#define BINNING_HIST_STEP_PPM 5000  // 0,5% por barra: -8% a +8% (extremos acumulam o resto)
+#define BINNING_RATE_WINDOW 8       // Peças usadas no ritmo (peças/min)
+#define BINNING_IDLE_US 10000000u   // Parado por mais que isso: o ritmo recomeça
+
+typedef struct {
+    uint32_t nominal_mohm;          // 0 = aprende com a próxima peça
+    uint16_t tolerance_tenths;      // Tolerância em décimos de %
+    bool armed;                     // Peça retirada desde a última classificação
+    bin_class_t last;
+    int32_t last_dev_ppm;
+    uint32_t counts[BIN_COUNT];
+    uint16_t hist[BINNING_HIST_BINS];
+    uint64_t times_us[BINNING_RATE_WINDOW]; // Instantes das últimas peças (anel)
+    uint8_t times_head, times_count;
+} binning_t;
+
+void binning_init(binning_t *b, uint32_t nominal_mohm, uint16_t tolerance_tenths);
+bin_class_t binning_classify(const binning_t *b, uint32_t r_mohm, uint32_t closest_mohm, int32_t *dev_ppm);
+void binning_removed(binning_t *b);
+bin_class_t binning_part(binning_t *b, uint32_t r_mohm, uint32_t closest_mohm, uint64_t now_us);
+uint32_t binning_total(const binning_t *b);
+uint32_t binning_parts_per_minute(const binning_t *b, uint64_t now_us);
+
+#endif
@@ -0,0 +1,22 @@
+#include "buzzer.h"
+#include "hardware/clocks.h"
+#include "hardware/pwm.h"
+
+#define BUZZER_WRAP 999 // 1000 passos por período
+
+static uint buzzer_gpio;
+
+void buzzer_init(uint gpio, uint32_t freq_hz) {
+    buzzer_gpio = gpio;
+    gpio_set_function(gpio, GPIO_FUNC_PWM);
+    pwm_config config = pwm_get_default_config();
+    pwm_config_set_clkdiv(&config, (float)clock_get_hz(clk_sys) / (freq_hz * (BUZZER_WRAP + 1)));
+    pwm_config_set_wrap(&config, BUZZER_WRAP);
+    pwm_init(pwm_gpio_to_slice_num(gpio), &config, true);
+    pwm_set_gpio_level(gpio, 0);
+}
+
+// Ciclo de 50% com o tom, 0 sem
+void buzzer_set(bool on) {
+    pwm_set_gpio_level(buzzer_gpio, on ? (BUZZER_WRAP + 1) / 2 : 0);
+}
@@ -0,0 +1,14 @@
+#ifndef BUZZER_H
+#define BUZZER_H
+
+#include "pico/stdlib.h"
+
+// Buzzer passivo por PWM: tom de frequência fixa, ligado/desligado só pelo
+// nível do canal (uma escrita de registrador, segura em IRQ e no outro core)
+
+#define BUZZER_PIN 21 // Buzzer A da BitDogLab
+
+void buzzer_init(uint gpio, uint32_t freq_hz);
+void buzzer_set(bool on);
+
+#endif
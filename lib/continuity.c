@@ -0,0 +1,47 @@
+#include "continuity.h"
+#include "divider.h"
+#include "pico/platform.h"
+
+void continuity_init(continuity_t *c) {
+    c->on_code = 0;
+    c->off_code = 0;
+    c->closed = false;
+    c->run = 0;
+    c->detect_samples = 0;
+    c->transitions = 0;
+}
+
+// Código bruto esperado para R no divisor: FS * R / (Rk + R), mais o offset
+static uint16_t continuity_code(uint32_t r_mohm, uint32_t r_known_mohm, int32_t offset_q4) {
+    int64_t q4 = ((uint64_t)DIVIDER_ADC_FULL_SCALE * 16u * r_mohm) / ((uint64_t)r_known_mohm + r_mohm) + offset_q4;
+    q4 = (q4 + 8) >> 4;
+    return q4 < 0 ? 0 : q4 > DIVIDER_ADC_FULL_SCALE ? DIVIDER_ADC_FULL_SCALE : (uint16_t)q4;
+}
+
+void continuity_set_limit(continuity_t *c, uint32_t r_limit_mohm, uint32_t r_known_mohm, int32_t offset_q4) {
+    c->on_code = continuity_code(r_limit_mohm, r_known_mohm, offset_q4);
+    uint16_t off = continuity_code(r_limit_mohm + (r_limit_mohm >> CONTINUITY_HYST_SHIFT), r_known_mohm, offset_q4);
+    c->off_code = off > c->on_code ? off : c->on_code + 1; // Pelo menos um código de histerese
+}
+
+// Conta, do fim do bloco para trás, as amostras do lado oposto ao estado
+// atual (normalmente para na primeira); retorna true se o estado mudou.
+// Roda da SRAM, no IRQ do bloco.
+bool __not_in_flash_func(continuity_block)(continuity_t *c, const uint16_t *samples, uint32_t count) {
+    uint32_t n = 0;
+    if (c->closed) {
+        while (n < count && (samples[count - 1 - n] & 0x0FFF) > c->off_code)
+            n++;
+    } else {
+        while (n < count && (samples[count - 1 - n] & 0x0FFF) <= c->on_code)
+            n++;
+    }
+    c->run = n == count ? c->run + n : n;
+    if (c->run < CONTINUITY_SETTLE)
+        return false;
+    c->closed = !c->closed;
+    c->detect_samples = c->run;
+    c->run = 0;
+    c->transitions++;
+    return true;
+}
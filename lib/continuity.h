@@ -0,0 +1,32 @@
+#ifndef CONTINUITY_H
+#define CONTINUITY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Teste de continuidade direto nas amostras brutas do ADC
+//
+// O limite em ohms vira um código do ADC uma vez (com o resistor conhecido
+// e o offset da calibração); por amostra há só uma comparação, sem divisão
+// nem filtro. O estado muda quando as últimas CONTINUITY_SETTLE amostras
+// seguidas estão do outro lado do limiar, com histerese entre fechar e
+// abrir. `detect_samples` guarda quantas amostras se passaram entre o
+// início do contato (ou da abertura) e a decisão.
+
+#define CONTINUITY_SETTLE 16      // Amostras seguidas para mudar de estado
+#define CONTINUITY_HYST_SHIFT 1   // Abre acima de limite + limite / 2
+
+typedef struct {
+    uint16_t on_code;        // Fecha com amostras <= on_code
+    uint16_t off_code;       // Abre com amostras > off_code
+    bool closed;
+    uint32_t run;            // Amostras seguidas do lado oposto ao estado, até o fim do bloco
+    uint32_t detect_samples; // Atraso da última mudança, em amostras
+    uint32_t transitions;
+} continuity_t;
+
+void continuity_init(continuity_t *c);
+void continuity_set_limit(continuity_t *c, uint32_t r_limit_mohm, uint32_t r_known_mohm, int32_t offset_q4);
+bool continuity_block(continuity_t *c, const uint16_t *samples, uint32_t count);
+
+#endif
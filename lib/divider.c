@@ -0,0 +1,39 @@
+#include "divider.h"
+
+// R_x em mΩ, arredondado; satura em DIVIDER_R_INFINITE quando a média
+// atinge o fundo de escala (a versão em float dividia por zero)
+uint32_t divider_rx_mohm(uint32_t sum, uint32_t count, uint32_t r_known_mohm) {
+    uint32_t full = DIVIDER_ADC_FULL_SCALE * count;
+    if (sum >= full)
+        return DIVIDER_R_INFINITE;
+    uint32_t den = full - sum;
+    uint64_t r = ((uint64_t)r_known_mohm * sum + den / 2) / den;
+    return r > DIVIDER_R_INFINITE ? DIVIDER_R_INFINITE : (uint32_t)r;
+}
+
+uint32_t divider_clamp(uint32_t r_mohm, uint32_t r_min_mohm, uint32_t r_max_mohm) {
+    if (r_mohm < r_min_mohm)
+        return r_min_mohm;
+    if (r_mohm > r_max_mohm)
+        return r_max_mohm;
+    return r_mohm;
+}
+
+// Incerteza em R_x correspondente a ±delta_q8 no código médio, pela derivada
+// do divisor: dR/dc = Rk * FS / (FS - c)²  (em Q8: Rk * FS * 256 / a², a = FS*256 - c_q8)
+uint32_t divider_spread_mohm(uint32_t mean_q8, uint32_t delta_q8, uint32_t r_known_mohm) {
+    uint32_t full_q8 = DIVIDER_ADC_FULL_SCALE << 8;
+    if (mean_q8 >= full_q8)
+        return DIVIDER_R_INFINITE;
+    if (delta_q8 > 0xFFFF)
+        delta_q8 = 0xFFFF; // Mantém o numerador em 64 bits
+    uint64_t a = full_q8 - mean_q8;
+    uint64_t r = ((uint64_t)r_known_mohm * DIVIDER_ADC_FULL_SCALE * delta_q8 * 256u) / (a * a);
+    return r > DIVIDER_R_INFINITE ? DIVIDER_R_INFINITE : (uint32_t)r;
+}
+
+// Código médio em Q8 (1/256 de código), truncado: erro < 1/256 de código.
+// soma << 8 cabe em 32 bits para blocos de até 4096 amostras de 12 bits.
+uint32_t divider_mean_q8(uint32_t sum, uint32_t count) {
+    return count ? (sum << 8) / count : 0;
+}
@@ -0,0 +1,23 @@
+#ifndef DIVIDER_H
+#define DIVIDER_H
+
+#include <stdint.h>
+
+// Conversão do divisor de tensão em ponto fixo (o RP2040 não tem FPU)
+//
+// Resistências em miliohms (uint32_t: até ~4,29 MΩ). O código médio do ADC
+// entra como soma/contagem do bloco, sem passar por uma média em float:
+//   R_x = Rk * media / (FS - media) = Rk * soma / (FS * n - soma)
+// O quociente é calculado em 64 bits e arredondado para o mΩ mais próximo,
+// então o erro de conversão é de no máximo 0,5 mΩ (a versão em float tinha
+// erro relativo de ~2e-7, ou seja, até ~20 mΩ em 100 kΩ).
+
+#define DIVIDER_ADC_FULL_SCALE 4095u
+#define DIVIDER_R_INFINITE UINT32_MAX   // Código em fundo de escala (circuito aberto)
+
+uint32_t divider_rx_mohm(uint32_t sum, uint32_t count, uint32_t r_known_mohm);
+uint32_t divider_clamp(uint32_t r_mohm, uint32_t r_min_mohm, uint32_t r_max_mohm);
+uint32_t divider_mean_q8(uint32_t sum, uint32_t count);
+uint32_t divider_spread_mohm(uint32_t mean_q8, uint32_t delta_q8, uint32_t r_known_mohm);
+
+#endif
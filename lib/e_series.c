@@ -0,0 +1,151 @@
+#include "e_series.h"
+
+#define E_SERIES_MIN_SCALE 10       // mantissa x 10 mΩ = 1,00 Ω
+#define E_SERIES_MAX_SCALE 1000000  // mantissa x 1 kΩ... 999 kΩ
+
+// Valor comercial mais próximo de r_mohm (empate fica com o menor). A década
+// vem do próprio valor e a mantissa é encontrada por busca binária.
+uint32_t e_series_nearest(e_series_id_t series, uint32_t r_mohm) {
+    const e_series_t *s = &e_series_tables[series];
+    uint32_t scale = E_SERIES_MIN_SCALE;
+    while (scale < E_SERIES_MAX_SCALE && r_mohm >= 1000u * scale)
+        scale *= 10;
+
+    uint32_t first = s->mantissas[0] * scale;
+    if (r_mohm <= first)
+        return first;
+
+    // Maior mantissa com valor <= r
+    int lo = 0, hi = s->count - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (s->mantissas[mid] * scale <= r_mohm)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    uint32_t below = s->mantissas[lo] * scale;
+    uint32_t above = lo + 1 < s->count ? s->mantissas[lo + 1] * scale : 1000u * scale;
+    return (r_mohm - below) <= (above - r_mohm) ? below : above;
+}
+
+// Faixas do código de cores para r_mohm (a partir de 10 Ω): `digits` dígitos
+// significativos e o expoente do multiplicador. Só inteiros; o arredondamento
+// acontece uma vez, na última faixa, e um "vai um" (995 -> 100) sobe a década.
+void e_series_bands(uint32_t r_mohm, uint8_t digits, uint8_t *bands, uint8_t *multiplier) {
+    uint32_t ohms = (r_mohm + 500u) / 1000u;
+    uint32_t limit = digits == 3 ? 1000u : 100u;
+    uint32_t scale = 1;
+    uint8_t m = 0;
+    while (ohms >= limit * scale) {
+        scale *= 10;
+        m++;
+    }
+    uint32_t value = (ohms + scale / 2) / scale;
+    if (value >= limit) {
+        value /= 10;
+        m++;
+    }
+    for (int i = digits - 1; i >= 0; i--) {
+        bands[i] = value % 10;
+        value /= 10;
+    }
+    *multiplier = m;
+}
+
+// Código do ADC (Q8) no ponto médio entre dois valores vizinhos a e b:
+// R_x = Rk * c / (FS - c)  =>  c = FS * R / (Rk + R), com R = (a + b) / 2
+static uint32_t e_series_threshold_q8(uint32_t a_mohm, uint32_t b_mohm, uint32_t r_known_mohm) {
+    uint64_t sum = (uint64_t)a_mohm + b_mohm;
+    return (uint32_t)(((uint64_t)E_SERIES_ADC_FULL_SCALE * 256u * sum) / (2u * (uint64_t)r_known_mohm + sum));
+}
+
+static uint16_t e_series_nearest_index(const e_series_lut_t *lut, uint32_t r_mohm) {
+    uint16_t best = 0;
+    for (uint16_t i = 1; i < lut->count; i++) {
+        uint32_t d_best = r_mohm > lut->values_mohm[best] ? r_mohm - lut->values_mohm[best] : lut->values_mohm[best] - r_mohm;
+        uint32_t d = r_mohm > lut->values_mohm[i] ? r_mohm - lut->values_mohm[i] : lut->values_mohm[i] - r_mohm;
+        if (d < d_best)
+            best = i;
+    }
+    return best;
+}
+
+// Monta a tabela com os valores da série entre o vizinho abaixo de r_min e o
+// vizinho acima de r_max. Leituras fora da faixa são limitadas ao valor mais
+// próximo de r_min/r_max, como na limitação de R_x antes da busca. O resistor
+// conhecido entra em mΩ, com a resolução da calibração.
+bool e_series_lut_build(e_series_lut_t *lut, e_series_id_t series, uint32_t r_known_mohm, uint32_t r_min_ohm, uint32_t r_max_ohm) {
+    const e_series_t *s = &e_series_tables[series];
+    uint32_t r_min = r_min_ohm * 1000u, r_max = r_max_ohm * 1000u;
+    uint32_t prev = 0;
+    bool done = false;
+
+    lut->series = series;
+    lut->r_known_mohm = r_known_mohm;
+    lut->count = 0;
+    for (uint32_t scale = E_SERIES_MIN_SCALE; scale <= E_SERIES_MAX_SCALE && !done; scale *= 10) {
+        for (uint8_t i = 0; i < s->count && !done; i++) {
+            uint32_t v = s->mantissas[i] * scale;
+            if (v >= r_min) {
+                if (lut->count == 0 && prev && v > r_min)
+                    lut->values_mohm[lut->count++] = prev;
+                if (lut->count >= E_SERIES_LUT_MAX)
+                    return false;
+                lut->values_mohm[lut->count++] = v;
+                done = v >= r_max;
+            }
+            prev = v;
+        }
+    }
+    if (lut->count == 0)
+        return false;
+
+    for (uint16_t i = 0; i + 1 < lut->count; i++)
+        lut->thresholds_q8[i] = e_series_threshold_q8(lut->values_mohm[i], lut->values_mohm[i + 1], lut->r_known_mohm);
+    lut->index_min = e_series_nearest_index(lut, r_min);
+    lut->index_max = e_series_nearest_index(lut, r_max);
+    return true;
+}
+
+// Índice do valor mais próximo para um código médio em Q8: número de
+// limiares estritamente abaixo do código (busca binária)
+uint16_t e_series_lut_index(const e_series_lut_t *lut, uint32_t code_q8) {
+    uint16_t lo = 0, hi = lut->count - 1;
+    while (lo < hi) {
+        uint16_t mid = (lo + hi) / 2;
+        if (code_q8 > lut->thresholds_q8[mid])
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo < lut->index_min)
+        lo = lut->index_min;
+    if (lo > lut->index_max)
+        lo = lut->index_max;
+    return lo;
+}
+
+// Índice com histerese: o índice anterior é mantido enquanto o código não
+// passar do limiar vizinho por mais de hyst_q8 (evita faixas piscando quando
+// a leitura está em cima de uma fronteira de decisão)
+uint16_t e_series_lut_index_hyst(const e_series_lut_t *lut, uint32_t code_q8, uint16_t prev, uint32_t hyst_q8) {
+    uint32_t lo = code_q8 > hyst_q8 ? code_q8 - hyst_q8 : 0;
+    uint16_t below = e_series_lut_index(lut, lo);
+    uint16_t above = e_series_lut_index(lut, code_q8 + hyst_q8);
+    if (prev >= below && prev <= above)
+        return prev;
+    return e_series_lut_index(lut, code_q8);
+}
+
+uint32_t e_series_lut_lookup(const e_series_lut_t *lut, uint32_t code_q8) {
+    return lut->values_mohm[e_series_lut_index(lut, code_q8)];
+}
+
+// O valor comercial está decidido se todo o intervalo code ± margin cai no
+// mesmo índice (fora da faixa, o índice limitado também conta como decidido)
+bool e_series_lut_decided(const e_series_lut_t *lut, uint32_t code_q8, uint32_t margin_q8) {
+    uint32_t lo = code_q8 > margin_q8 ? code_q8 - margin_q8 : 0;
+    uint32_t hi = code_q8 + margin_q8 < code_q8 ? UINT32_MAX : code_q8 + margin_q8;
+    return e_series_lut_index(lut, lo) == e_series_lut_index(lut, hi);
+}
@@ -0,0 +1,57 @@
+#ifndef E_SERIES_H
+#define E_SERIES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Séries de valores comerciais (IEC 60063)
+//
+// As mantissas de 3 dígitos (100..999) de cada série são geradas em tempo de
+// build por tools/gen_e_series.py. Os valores são tratados em miliohms para
+// cobrir décadas abaixo de 100 Ω sem ponto flutuante.
+
+typedef enum {
+    E_SERIES_E6,
+    E_SERIES_E12,
+    E_SERIES_E24,
+    E_SERIES_E48,
+    E_SERIES_E96,
+    E_SERIES_E192,
+    E_SERIES_COUNT
+} e_series_id_t;
+
+typedef struct {
+    const char *name;
+    const uint16_t *mantissas;  // Crescentes, de 100 a 999
+    uint8_t count;
+    uint8_t digits;             // Dígitos significativos no código de cores
+    uint16_t tolerance_tenths;  // Tolerância em décimos de %
+} e_series_t;
+
+extern const e_series_t e_series_tables[E_SERIES_COUNT];
+
+#define E_SERIES_ADC_FULL_SCALE 4095
+#define E_SERIES_LUT_MAX 600   // E192 cobre ~3 décadas entre 510 Ω e 100 kΩ
+
+// Tabela de decisão em códigos do ADC para um divisor com resistor conhecido.
+// O valor comercial mais próximo de R_x é escolhido comparando o código médio
+// (em Q8, 1/256 de código) com os limiares entre valores vizinhos, sem
+// nenhuma divisão por leitura.
+typedef struct {
+    e_series_id_t series;
+    uint32_t r_known_mohm;
+    uint16_t count;
+    uint16_t index_min, index_max;                // Limitação à faixa suportada
+    uint32_t values_mohm[E_SERIES_LUT_MAX];
+    uint32_t thresholds_q8[E_SERIES_LUT_MAX - 1]; // Entre values[i] e values[i + 1]
+} e_series_lut_t;
+
+uint32_t e_series_nearest(e_series_id_t series, uint32_t r_mohm);
+void e_series_bands(uint32_t r_mohm, uint8_t digits, uint8_t *bands, uint8_t *multiplier);
+bool e_series_lut_build(e_series_lut_t *lut, e_series_id_t series, uint32_t r_known_mohm, uint32_t r_min_ohm, uint32_t r_max_ohm);
+uint16_t e_series_lut_index(const e_series_lut_t *lut, uint32_t code_q8);
+uint32_t e_series_lut_lookup(const e_series_lut_t *lut, uint32_t code_q8);
+uint16_t e_series_lut_index_hyst(const e_series_lut_t *lut, uint32_t code_q8, uint16_t prev, uint32_t hyst_q8);
+bool e_series_lut_decided(const e_series_lut_t *lut, uint32_t code_q8, uint32_t margin_q8);
+
+#endif
@@ -0,0 +1,15 @@
+#include <stdio.h>
+#include "format.h"
+
+// Função para formatar o valor da resistência para exibição
+void format_resistance_value(uint32_t r_mohm, char *buffer, int buffer_size) {
+    if (r_mohm < 1000000) {
+        // Valores menores que 1kΩ: mostrar em Ω com 1 casa decimal
+        uint32_t decimos = (r_mohm + 50) / 100;
+        snprintf(buffer, buffer_size, "%lu.%lu Ω", (unsigned long)(decimos / 10), (unsigned long)(decimos % 10));
+    } else {
+        // Valores maiores ou iguais a 1kΩ: mostrar em kΩ com 2 casas decimais
+        uint32_t centesimos = (r_mohm + 5000) / 10000;
+        snprintf(buffer, buffer_size, "%lu.%02lu kΩ", (unsigned long)(centesimos / 100), (unsigned long)(centesimos % 100));
+    }
+}
@@ -0,0 +1,9 @@
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include <stdint.h>
+
+// Texto das resistências exibidas (Ω com 1 casa ou kΩ com 2), só com inteiros
+void format_resistance_value(uint32_t r_mohm, char *buffer, int buffer_size);
+
+#endif
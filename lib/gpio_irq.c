@@ -0,0 +1,38 @@
+#include "gpio_irq.h"
+
+typedef struct {
+    gpio_event_fn_t handler;
+    uint32_t events;        // Borda que conta como toque
+    uint32_t debounce_us;
+    uint64_t last_us;       // Última borda de qualquer tipo, aceita ou não
+} gpio_irq_entry_t;
+
+static gpio_irq_entry_t entries[GPIO_IRQ_PIN_COUNT];
+
+static void gpio_irq_dispatch(uint gpio, uint32_t events) {
+    if (gpio >= GPIO_IRQ_PIN_COUNT || !entries[gpio].handler)
+        return;
+    gpio_irq_entry_t *entry = &entries[gpio];
+    uint64_t now = time_us_64();
+    bool stable = !entry->last_us || now - entry->last_us >= entry->debounce_us;
+    entry->last_us = now;
+    // Só a borda pedida, com o pino já no nível dela e estável antes dela: a
+    // trepidação da soltura (mesmo depois de um toque longo) cai na janela
+    // aberta pela borda de subida e é descartada
+    uint32_t active = events & entry->events;
+    bool level = gpio_get(gpio);
+    if (!stable || !active || (active == GPIO_IRQ_EDGE_FALL && level) || (active == GPIO_IRQ_EDGE_RISE && !level))
+        return;
+    entry->handler(gpio, active, now);
+}
+
+void gpio_irq_register(uint gpio, uint32_t events, uint32_t debounce_us, gpio_event_fn_t handler) {
+    if (gpio >= GPIO_IRQ_PIN_COUNT)
+        return;
+    entries[gpio].handler = handler;
+    entries[gpio].events = events;
+    entries[gpio].debounce_us = debounce_us;
+    entries[gpio].last_us = 0;
+    // As duas bordas, para a janela do debounce contar também a soltura
+    gpio_set_irq_enabled_with_callback(gpio, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, &gpio_irq_dispatch);
+}
@@ -0,0 +1,20 @@
+#ifndef GPIO_IRQ_H
+#define GPIO_IRQ_H
+
+#include "pico/stdlib.h"
+
+// Despacho de IRQs de GPIO por pino, com debounce por timestamp
+//
+// O SDK aceita apenas um callback de GPIO por core; este módulo registra esse
+// callback e repassa ao tratador do pino a borda pedida (`events`). As duas
+// bordas são monitoradas: a pedida só vale se nenhuma outra borda chegou nos
+// `debounce_us` anteriores, então a trepidação ao soltar o botão não conta
+// como outro toque, por mais longo que tenha sido o toque.
+
+#define GPIO_IRQ_PIN_COUNT 30
+
+typedef void (*gpio_event_fn_t)(uint gpio, uint32_t events, uint64_t timestamp_us);
+
+void gpio_irq_register(uint gpio, uint32_t events, uint32_t debounce_us, gpio_event_fn_t handler);
+
+#endif
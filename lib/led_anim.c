@@ -0,0 +1,53 @@
+#include "led_anim.h"
+
+#define LED_ANIM_RETRY_US 200 // Matriz ainda no quadro anterior (latch)
+
+static const led_anim_seq_t *anim_seq = NULL;
+static uint8_t anim_frame;
+static bool anim_pending;             // Quadro atual ainda não foi enviado
+static volatile alarm_id_t anim_alarm = 0;
+
+// Agenda o próximo disparo: o quadro atual, se a matriz estava ocupada, ou
+// o seguinte depois do tempo de exibição deste
+static int64_t led_anim_show(void) {
+    draw_glyph(anim_seq->frames[anim_frame].glyph);
+    anim_pending = !write_leds_async();
+    return anim_pending ? LED_ANIM_RETRY_US : -(int64_t)anim_seq->frames[anim_frame].hold_ms * 1000;
+}
+
+// Um quadro por disparo. O retorno negativo reagenda em relação ao horário
+// previsto do disparo anterior, então a cadência não acumula atraso.
+static int64_t led_anim_tick(alarm_id_t id, void *user_data) {
+    if (!anim_pending && ++anim_frame >= anim_seq->count) {
+        anim_seq = anim_seq->next;
+        anim_frame = 0;
+        if (!anim_seq) {
+            anim_alarm = 0;
+            return 0;
+        }
+    }
+    return led_anim_show();
+}
+
+// Começa a sequência pelo primeiro quadro, já desenhado nesta chamada
+void led_anim_play(const led_anim_seq_t *seq) {
+    led_anim_stop();
+    if (!seq || seq->count == 0)
+        return;
+    anim_seq = seq;
+    anim_frame = 0;
+    int64_t next = led_anim_show();
+    alarm_id_t id = add_alarm_in_us(next < 0 ? -next : next, led_anim_tick, NULL, true);
+    anim_alarm = id > 0 ? id : 0;
+}
+
+void led_anim_stop(void) {
+    if (anim_alarm > 0)
+        cancel_alarm(anim_alarm);
+    anim_alarm = 0;
+    anim_seq = NULL;
+}
+
+bool led_anim_running(void) {
+    return anim_alarm > 0;
+}
@@ -0,0 +1,32 @@
+#ifndef LED_ANIM_H
+#define LED_ANIM_H
+
+#include "pico/stdlib.h"
+#include "ws2818b.h"
+
+// Animações da matriz de LEDs conduzidas por alarme
+//
+// Uma sequência é uma lista de quadros-chave (padrão + tempo de exibição).
+// Cada quadro é desenhado e enviado por DMA no callback de um alarme, que se
+// reagenda para o próximo quadro, então a animação roda enquanto o programa
+// faz outra coisa (ou dorme). Ao fim da lista a sequência segue para `next`:
+// a própria sequência repete, NULL para no último quadro.
+
+typedef struct {
+    const led_glyph_t *glyph;
+    uint16_t hold_ms;       // Tempo de exibição do quadro
+} led_keyframe_t;
+
+typedef struct led_anim_seq {
+    const led_keyframe_t *frames;
+    uint8_t count;
+    const struct led_anim_seq *next;
+} led_anim_seq_t;
+
+// Enquanto a animação roda, o buffer da matriz pertence a ela: quem desenha
+// fora dela deve chamar led_anim_stop() antes
+void led_anim_play(const led_anim_seq_t *seq);
+void led_anim_stop(void);
+bool led_anim_running(void);
+
+#endif
@@ -0,0 +1,612 @@
+#include "meter.h"
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/platform.h"
+#include "hardware/sync.h"
+#include "buzzer.h"
+#include "continuity.h"
+#include "divider.h"
+#include "e_series.h"
+#include "probe.h"
+#include "prof.h"
+#include "robust_filter.h"
+#include "seqlock.h"
+#include "stats.h"
+
+#define CONFIDENCE_Z_Q8 660        // z = 2,58 em Q8: 99% de confiança na decisão
+#define FILTER_IIR_SHIFT 2         // IIR da saída do filtro: y += (x - y) / 4 por grupo
+#define FILTER_MIN_DEV_Q4 48       // Grupos a mais de 3 códigos da mediana podem ser picos
+#define FILTER_STEP_GROUPS 4       // 4 grupos (64 amostras) seguidos fora = peça nova
+#define PROBE_OPEN_CODE 4050       // Acima disso R_x > ~900kΩ: ponta aberta
+#define PROBE_SHORT_CODE 20        // Abaixo disso R_x < ~50Ω: curto
+#define HOLD_MS 5000               // Última leitura estável congelada ao retirar a peça
+#define HYSTERESIS_Q8 128          // Meio código além do limiar para trocar o valor comercial
+#define R_MIN_OHM 510              // Faixa suportada
+#define R_MAX_OHM 100000
+#define TELEMETRY_BLOCK_DIVIDER 2  // Envia 1 bloco bruto a cada N (o CDC não sustenta 300 KB/s)
+
+SEQLOCK_ASSERT_FITS(meter_reading_t);
+
+// Estado de cada divisor. Na varredura as amostras do bloco chegam
+// intercaladas e são separadas em `samples`; só grupos inteiros do filtro
+// são consumidos e o resto fica para o próximo bloco.
+#define CHANNEL_SAMPLES (CANAIS > 1 ? ADC_DMA_BLOCK_SAMPLES / CANAIS + 1 + ROBUST_GROUP : 1)
+typedef struct {
+    e_series_lut_t lut;
+    bool lut_valid;
+    // Compartilhado com o IRQ de DMA (lido com interrupções mascaradas)
+    robust_filter_t filter;
+    stats_t stats; // Grupos aceitos pelo filtro desde o último degrau
+    volatile probe_level_t level;
+    volatile bool step_pending;
+    uint16_t samples[CHANNEL_SAMPLES];
+    uint16_t n_samples;
+    // Só na tarefa de aquisição
+    probe_t probe;
+    bool published;              // Algo publicado desde o último reinício
+    meter_reading_t last_stable; // Congelada no HOLD
+    uint16_t closest_index;
+} channel_t;
+
+// Toques nos botões (core 0) a gravar pelo core 1, único produtor do anel
+typedef struct {
+    volatile uint8_t count;
+    volatile uint8_t value; // Modo ou série depois do toque
+    volatile uint32_t time_us;
+    uint8_t recorded;       // Só no core 1
+} touch_t;
+
+static const adc_cal_t *cal;
+static const uint16_t *correction_q4;
+static scheduler_t *sched;
+static int task_id;
+
+static channel_t channels[CANAIS];
+static seqlock_t published[CANAIS];
+
+// Ajustes do core 0
+static volatile uint8_t series_requested = E_SERIES_E24;
+static volatile uint32_t samples_per_reading = METER_SAMPLES_DEFAULT; // 0 = adaptativo, senão fixo
+static volatile bool calibration_changed = false; // Core 1 refaz a tabela de decisão
+
+// Varredura: canal da próxima amostra (avança com o resto de cada bloco)
+static uint8_t scan_phase = 0;
+static volatile uint32_t blocks_received = 0;
+
+// Tempo desde o boot até a primeira leitura decidida (ponta aberta, curto ou
+// valor estável; aberta e curto publicam já no primeiro bloco); 0 enquanto
+// não houver
+static volatile uint32_t first_reading_us = 0;
+
+// Continuidade: só no primeiro canal. O IRQ decide a cada bloco e liga o
+// bipe ali mesmo.
+static continuity_t continuity;
+static bool continuity_limit_valid = false;
+static volatile bool continuity_on = false;
+static volatile bool continuity_closed = false;
+static volatile uint32_t continuity_delay_us = 0;
+static volatile uint32_t continuity_delay_max_us = 0;
+
+// Separação de peças: só no primeiro canal. Alvo e tolerância pedidos pelo
+// core 0 (0 = a primeira peça ensina / a tolerância da série)
+static binning_t binning;
+static volatile bool binning_on = false;
+static bool binning_in_use = false;
+static volatile uint32_t binning_nominal_mohm = 0;
+static volatile uint16_t binning_tolerance_tenths = 0;
+static volatile bool binning_target_changed = false; // Core 1 recomeça as contagens
+
+// Fluxo binário e gravação de sessão: o core 0 pede, o core 1 reinicia os
+// canais, grava o cabeçalho e passa a enviar todos os blocos e os toques
+static telemetry_t telemetry;
+static volatile bool streaming = false;
+static volatile bool recording_requested = false;
+static bool recording = false; // Só no core 1
+static volatile uint8_t display_mode = 0;
+static touch_t touches[2]; // TELEMETRY_EVENT_BUTTON_A e _JOY
+
+// Capturas de calibração
+static volatile meter_capture_t capture = METER_CAPTURE_NONE;
+static uint8_t capture_channel = 0;
+static const uint16_t *capture_table_q4;
+static volatile uint64_t capture_sum_q4;
+static volatile uint32_t capture_n;
+static uint32_t *capture_hist;
+
+// Publica a leitura para o core 0 e, com a telemetria ligada, para o host.
+// No modo de separação leva junto o alvo, as contagens e o ritmo.
+static void publish(uint8_t index, meter_reading_t *r) {
+    if (index == 0 && binning_in_use) {
+        r->nominal_mohm = binning.nominal_mohm;
+        r->pecas_min = binning_parts_per_minute(&binning, time_us_64());
+        memcpy(r->contagem, &binning.counts[BIN_PASS], sizeof(r->contagem));
+    }
+    if (first_reading_us == 0 && r->estado != PROBE_SETTLING)
+        first_reading_us = time_us_32();
+    channels[index].published = true;
+    seqlock_write(&published[index], r, sizeof(*r));
+    if (streaming || recording) {
+        telemetry_reading_t t = {
+            .r_x_mohm = r->r_x_mohm,
+            .closest_mohm = r->closest_mohm,
+            .incerteza_mohm = r->incerteza_mohm,
+            .media_q8 = r->media_q8,
+            .amostras = r->amostras,
+            .dropped_packets = telemetry.dropped_packets,
+            .adc_overruns = adc_dma_overruns(),
+            .estado = r->estado,
+            .series = r->series,
+            .canal = index,
+        };
+        uint32_t status = save_and_disable_interrupts(); // O IRQ do DMA também produz
+        telemetry_put_reading(&telemetry, &t);
+        restore_interrupts(status);
+    }
+}
+
+// Publica só o estado da ponta (aberta/curto), sem valores
+static void publish_state(uint8_t index, probe_state_t state) {
+    meter_reading_t r = {0};
+    r.estado = state;
+    r.series = channels[index].lut.series;
+    publish(index, &r);
+}
+
+// Avança a máquina de estados da ponta de um canal e publica a leitura.
+// Com uma peça conectada a leitura sai a cada bloco: a resistência exibida
+// vem do filtro robusto (atualiza rápido sem oscilar); o valor comercial e a
+// incerteza vêm das amostras aceitas desde a última troca de peça. No modo
+// fixo a leitura fica decidida a cada `samples_per_reading` amostras; no
+// adaptativo, assim que o intervalo de confiança do código médio cabe inteiro
+// entre dois limiares da série, o que com ruído normal acontece no primeiro
+// bloco longe dos limiares, e a média continua acumulando enquanto a peça
+// não muda. Aberto, curto e HOLD só publicam na mudança de estado e, para a
+// ponta que começa aberta (ou em curto) no boot ter o que mostrar, no
+// primeiro bloco depois de um reinício.
+static void process_channel(uint8_t index, bool new_calibration) {
+    channel_t *ch = &channels[index];
+    uint32_t r_known_mohm = cal->r_known_mohm[index];
+
+    // Tabela de decisão refeita quando outra série é selecionada ou a
+    // calibração muda o resistor conhecido
+    if (!ch->lut_valid || ch->lut.series != series_requested || new_calibration) {
+        uint32_t status = save_and_disable_interrupts();
+        stats_reset(&ch->stats);
+        ch->step_pending = true; // Decide de novo com a série nova
+        restore_interrupts(status);
+        ch->lut_valid = e_series_lut_build(&ch->lut, series_requested, r_known_mohm, R_MIN_OHM, R_MAX_OHM);
+        if (!ch->lut_valid)
+            return;
+        if (index == 0)
+            binning_in_use = false; // Outra série: ensina o alvo de novo
+    }
+
+    // Entrada no modo de separação ou alvo novo: contagens zeradas e alvo
+    // definido pelo console ou, sem ele, pela próxima peça
+    bool bin = index == 0 && binning_on;
+    if (index == 0 && (bin != binning_in_use || binning_target_changed)) {
+        binning_target_changed = false;
+        binning_in_use = bin;
+        uint16_t tolerance = binning_tolerance_tenths;
+        binning_init(&binning, binning_nominal_mohm,
+                     tolerance ? tolerance : e_series_tables[ch->lut.series].tolerance_tenths);
+    }
+    bin = index == 0 && binning_in_use;
+
+    PROF_START(t_conversion);
+    uint32_t status = save_and_disable_interrupts();
+    stats_t acc = ch->stats;
+    uint32_t filtered_q8 = robust_filter_estimate_q8(&ch->filter);
+    probe_level_t level = ch->level;
+    bool step = ch->step_pending;
+    ch->step_pending = false;
+    uint32_t fixed = samples_per_reading;
+    if (fixed && acc.n >= fixed)
+        stats_reset(&ch->stats); // Modo fixo: próxima leitura começa do zero
+    else if (acc.n >= METER_SAMPLES_MAX)
+        stats_decay(&ch->stats); // Memória longa, mas limitada
+    restore_interrupts(status);
+
+    // Tudo em inteiros: o RP2040 não tem FPU
+    uint32_t mean_q8 = stats_mean_q8(&acc);
+    uint32_t margin_q8 = ((uint64_t)CONFIDENCE_Z_Q8 * stats_isqrt(stats_mean_var_q16(&acc))) >> 8;
+    bool decided;
+    if (fixed)
+        decided = acc.n >= fixed;
+    else
+        decided = acc.n >= METER_SAMPLES_MAX || (acc.n && e_series_lut_decided(&ch->lut, mean_q8, margin_q8));
+
+    probe_t *probe = &ch->probe;
+    bool changed = probe_update(probe, level, step, decided, time_us_64());
+    if (bin && level == PROBE_LEVEL_OPEN)
+        binning_removed(&binning); // A próxima leitura estável é outra peça
+    switch (probe->state) {
+    case PROBE_OPEN:
+    case PROBE_SHORT:
+        if (changed || !ch->published)
+            publish_state(index, probe->state);
+        return;
+    case PROBE_HOLD:
+        if (changed) {
+            ch->last_stable.estado = PROBE_HOLD;
+            publish(index, &ch->last_stable);
+        }
+        return;
+    default:
+        break;
+    }
+
+    if (acc.n == 0)
+        return; // Bloco só com descartes logo após o degrau
+
+    meter_reading_t r = {0};
+    r.estado = probe->state;
+    r.media_q8 = filtered_q8;
+    r.amostras = acc.n;
+
+    // R_x = R_conhecido * media / (4095 - media), limitado à faixa de 510Ω a 100kΩ
+    // (código filtrado em Q8 = soma de 256 "amostras"; R_conhecido calibrado)
+    uint32_t r_x = divider_rx_mohm(filtered_q8, 256, r_known_mohm);
+    r.r_x_mohm = divider_clamp(r_x, R_MIN_OHM * 1000u, R_MAX_OHM * 1000u);
+    r.incerteza_mohm = divider_spread_mohm(mean_q8, margin_q8, r_known_mohm);
+    PROF_END(PROF_CONVERSION, t_conversion);
+    PROF_START(t_lookup);
+
+    // Valor comercial mais próximo direto do código médio (Q8), sem divisão:
+    // a tabela já tem os limiares de decisão em códigos do ADC. Depois de
+    // estável, a histerese segura o valor em cima de uma fronteira.
+    if (probe->state == PROBE_STABLE && !changed)
+        ch->closest_index = e_series_lut_index_hyst(&ch->lut, mean_q8, ch->closest_index, HYSTERESIS_Q8);
+    else
+        ch->closest_index = e_series_lut_index(&ch->lut, mean_q8);
+    r.closest_mohm = ch->lut.values_mohm[ch->closest_index];
+    r.series = ch->lut.series;
+    r.digits = e_series_tables[ch->lut.series].digits;
+
+    // Determina as cores das faixas com base no valor comercial
+    e_series_bands(r.closest_mohm, r.digits, r.bands, &r.multiplier);
+    PROF_END(PROF_LOOKUP, t_lookup);
+
+    // Separação: classifica na primeira leitura estável de cada peça
+    if (bin && probe->state == PROBE_STABLE) {
+        if (binning_part(&binning, r.r_x_mohm, r.closest_mohm, time_us_64()) == BIN_NONE) {
+            r.classe = ch->last_stable.classe; // Mesma peça: mantém o resultado
+            r.desvio_ppm = ch->last_stable.desvio_ppm;
+        } else {
+            r.classe = binning.last;
+            r.desvio_ppm = binning.last_dev_ppm;
+        }
+    }
+
+    if (probe->state == PROBE_STABLE)
+        ch->last_stable = r;
+    publish(index, &r);
+}
+
+// Estado inicial da aquisição, no boot e no início de uma gravação: filtro,
+// ponta e decisão de todos os canais, continuidade e separação. Com o IRQ
+// do DMA mascarado (ou ainda desligado).
+static void reset_channels(void) {
+    for (uint8_t c = 0; c < CANAIS; c++) {
+        channel_t *ch = &channels[c];
+        memset(ch, 0, sizeof(*ch));
+        robust_filter_init(&ch->filter, FILTER_IIR_SHIFT, FILTER_MIN_DEV_Q4, FILTER_STEP_GROUPS);
+        robust_filter_set_correction(&ch->filter, correction_q4); // Linearização por amostra
+        probe_init(&ch->probe, PROBE_OPEN_CODE, PROBE_SHORT_CODE, HOLD_MS * 1000);
+        ch->level = PROBE_LEVEL_OPEN;
+    }
+    continuity_init(&continuity);
+    continuity_limit_valid = false;
+    continuity_closed = false;
+    buzzer_set(false);
+    binning_in_use = false;
+}
+
+// Início da gravação (IRQ mascarado): reinicia os canais para que a
+// reprodução parta do mesmo estado e grava o cabeçalho e a calibração. O
+// primeiro bloco gravado é o próximo.
+static void start_recording(void) {
+    reset_channels();
+    telemetry_session_t s = {
+        .version = TELEMETRY_SESSION_VERSION,
+        .channels = CANAIS,
+        .phase = scan_phase,
+        .series = series_requested,
+        .mode = display_mode,
+        .rate_hz = METER_ADC_RATE_HZ,
+        .block = blocks_received,
+        .offset_q4 = cal->offset_q4,
+        .lin_first = cal->lin_first,
+        .lin_last = cal->lin_last,
+    };
+    memcpy(s.r_known_mohm, cal->r_known_mohm, sizeof(s.r_known_mohm));
+    telemetry_put_session(&telemetry, &s);
+    for (uint16_t c = 0; c < ADC_CAL_CODES; c += TELEMETRY_CAL_CHUNK)
+        telemetry_put_cal(&telemetry, c, &cal->center_q4[c], TELEMETRY_CAL_CHUNK);
+}
+
+// Toques ainda não gravados, antes do bloco em que o core 1 os viu (a
+// reprodução aplica o toque e depois entrega o bloco)
+static void record_touches(void) {
+    for (uint8_t i = 0; i < 2; i++) {
+        touch_t *t = &touches[i];
+        if (!recording) {
+            t->recorded = t->count; // A gravação só leva os toques novos
+            continue;
+        }
+        while (t->recorded != t->count) {
+            telemetry_event_t e = {blocks_received, t->time_us, TELEMETRY_EVENT_BUTTON_A + i, t->value};
+            telemetry_put_event(&telemetry, &e);
+            t->recorded++;
+        }
+    }
+}
+
+// Um bloco novo do DMA: todos os canais avançam juntos
+static void acquisition_task(void *ctx) {
+    adc_block_t block;
+    if (!adc_dma_read_block(&block))
+        return;
+    if (recording_requested != recording) {
+        uint32_t status = save_and_disable_interrupts();
+        if (recording_requested)
+            start_recording();
+        recording = recording_requested;
+        restore_interrupts(status);
+        if (recording)
+            return; // Este bloco foi filtrado antes do reinício
+    }
+    bool new_calibration = calibration_changed;
+    calibration_changed = false;
+    if (new_calibration || !continuity_limit_valid) {
+        // O limiar de continuidade é usado pelo IRQ
+        uint32_t status = save_and_disable_interrupts();
+        continuity_set_limit(&continuity, METER_CONTINUITY_LIMIT_OHM * 1000u, cal->r_known_mohm[0], cal->offset_q4);
+        restore_interrupts(status);
+        continuity_limit_valid = true;
+    }
+    for (uint8_t c = 0; c < CANAIS; c++)
+        process_channel(c, new_calibration);
+}
+
+// Caminho rápido da continuidade (IRQ do bloco, core 1): só compara as
+// amostras brutas com o limiar e liga ou desliga o bipe aqui mesmo, sem
+// passar pela tarefa de aquisição nem pelo core 0
+static void __not_in_flash_func(continuity_samples)(const uint16_t *samples, uint count) {
+    if (!continuity_on) {
+        if (continuity.closed) {
+            continuity.closed = false;
+            continuity_closed = false;
+            buzzer_set(false);
+        }
+        continuity.run = 0;
+        return;
+    }
+    if (continuity_block(&continuity, samples, count)) {
+        buzzer_set(continuity.closed);
+        continuity_closed = continuity.closed;
+        uint32_t delay = (uint64_t)continuity.detect_samples * 1000000u / (METER_ADC_RATE_HZ / CANAIS);
+        continuity_delay_us = delay;
+        if (delay > continuity_delay_max_us)
+            continuity_delay_max_us = delay;
+    }
+}
+
+// Amostras de um canal (no IRQ): reconhece ponta aberta/curto pelas
+// primeiras amostras (e pula o resto); com uma peça, filtra. As capturas de
+// calibração usam só o canal escolhido. Fica na SRAM, como block_ready.
+static void __not_in_flash_func(filter_channel)(uint8_t index, const uint16_t *samples, uint count) {
+    channel_t *ch = &channels[index];
+    if (index == 0)
+        continuity_samples(samples, count);
+    probe_level_t level = probe_level(&ch->probe, samples, count);
+    if (level != PROBE_LEVEL_PART) {
+        robust_filter_reset(&ch->filter);
+        stats_reset(&ch->stats);
+    } else if (robust_filter_block(&ch->filter, samples, count, &ch->stats)) {
+        ch->step_pending = true;
+    }
+    ch->level = level;
+    if (index != capture_channel)
+        return;
+    if (capture == METER_CAPTURE_MEAN && capture_n < METER_CAPTURE_SAMPLES) {
+        capture_sum_q4 += adc_cal_sum_q4(capture_table_q4, samples, count);
+        capture_n += count;
+    } else if (capture == METER_CAPTURE_HIST) {
+        adc_cal_hist_add(capture_hist, samples, count);
+    }
+}
+
+// Chamado no IRQ de DMA (core 1) a cada bloco completo, enquanto o buffer
+// ainda é válido. Com um canal o bloco vai direto para o filtro; na
+// varredura as amostras são separadas por canal (a fase avança com o resto
+// de cada bloco, já que 256 não é múltiplo do número de canais). Depois
+// acorda a tarefa de aquisição. Fica na SRAM por causa da separação por
+// amostra.
+static void __not_in_flash_func(block_ready)(const uint16_t *samples, uint count) {
+    PROF_START(t_block);
+    record_touches();
+    if (CANAIS == 1) {
+        filter_channel(0, samples, count);
+    } else {
+        for (uint i = 0; i < count; i++) {
+            channel_t *ch = &channels[scan_phase];
+            ch->samples[ch->n_samples++] = samples[i];
+            scan_phase = scan_phase + 1 == CANAIS ? 0 : scan_phase + 1;
+        }
+        for (uint8_t c = 0; c < CANAIS; c++) {
+            channel_t *ch = &channels[c];
+            uint used = ch->n_samples / ROBUST_GROUP * ROBUST_GROUP;
+            filter_channel(c, ch->samples, used);
+            ch->n_samples -= used;
+            memmove(ch->samples, &ch->samples[used], ch->n_samples * sizeof(uint16_t));
+        }
+    }
+    // Amostras brutas copiadas para o anel enquanto o buffer do DMA é válido:
+    // na gravação todos os blocos, com o instante de chegada
+    if (recording)
+        telemetry_put_block(&telemetry, blocks_received, time_us_32(), samples, count);
+    else if (streaming && blocks_received % TELEMETRY_BLOCK_DIVIDER == 0)
+        telemetry_put_samples(&telemetry, blocks_received, samples, count);
+    blocks_received++;
+    sched_post(sched, task_id);
+    PROF_END(PROF_ACQUISITION, t_block);
+}
+
+void meter_init(const adc_cal_t *c, const uint16_t *table_q4) {
+    cal = c;
+    correction_q4 = table_q4;
+    for (uint8_t i = 0; i < CANAIS; i++)
+        seqlock_init(&published[i]);
+    telemetry_init(&telemetry);
+}
+
+void meter_start(scheduler_t *s) {
+    reset_channels();
+    sched = s;
+    task_id = sched_add(sched, "aquisicao", acquisition_task, NULL, 0);
+    adc_dma_set_callback(block_ready);
+}
+
+void meter_restart(uint8_t phase, uint32_t block) {
+    reset_channels();
+    scan_phase = phase;
+    blocks_received = block;
+}
+
+void meter_skip(uint32_t blocks, uint32_t samples_per_block) {
+    scan_phase = (scan_phase + (uint64_t)blocks * samples_per_block) % CANAIS;
+    blocks_received += blocks;
+}
+
+uint32_t meter_read(uint8_t channel, meter_reading_t *r) {
+    return seqlock_read(&published[channel], r, sizeof(*r));
+}
+
+uint32_t meter_version(uint8_t channel) {
+    return seqlock_version(&published[channel]);
+}
+
+void meter_set_series(uint8_t series) {
+    series_requested = series;
+}
+
+uint8_t meter_series(void) {
+    return series_requested;
+}
+
+void meter_set_samples(uint32_t samples) {
+    samples_per_reading = samples;
+}
+
+uint32_t meter_samples(void) {
+    return samples_per_reading;
+}
+
+// Ligada, as contagens recomeçam e, sem alvo definido, a próxima peça o ensina
+void meter_set_binning(bool on) {
+    binning_on = on;
+}
+
+// O core 1 pode estar atualizando: uma peça a mais ou a menos não muda a
+// leitura das contagens e do histograma
+const binning_t *meter_binning(void) {
+    return &binning;
+}
+
+// Vale na hora: as contagens recomeçam contra o alvo novo
+void meter_set_binning_target(uint32_t nominal_mohm, uint16_t tolerance_tenths) {
+    binning_nominal_mohm = nominal_mohm;
+    binning_tolerance_tenths = tolerance_tenths;
+    binning_target_changed = true;
+}
+
+uint32_t meter_binning_nominal(void) {
+    return binning_nominal_mohm ? binning_nominal_mohm : binning.nominal_mohm;
+}
+
+uint16_t meter_binning_tolerance(void) {
+    uint16_t tolerance = binning_tolerance_tenths;
+    return tolerance ? tolerance : e_series_tables[series_requested].tolerance_tenths;
+}
+
+void meter_set_continuity(bool on) {
+    if (on)
+        continuity_delay_max_us = 0;
+    continuity_on = on;
+}
+
+meter_continuity_t meter_continuity(void) {
+    meter_continuity_t c = {continuity_closed, continuity_delay_us, continuity_delay_max_us};
+    return c;
+}
+
+void meter_calibration_changed(void) {
+    calibration_changed = true;
+}
+
+void meter_set_streaming(bool on) {
+    streaming = on;
+}
+
+void meter_set_recording(bool on) {
+    recording_requested = on;
+}
+
+void meter_set_display_mode(uint8_t mode) {
+    display_mode = mode;
+}
+
+void meter_touch(telemetry_event_type_t type, uint8_t value, uint32_t time_us) {
+    touch_t *t = &touches[type - TELEMETRY_EVENT_BUTTON_A];
+    t->value = value;
+    t->time_us = time_us;
+    t->count++;
+}
+
+telemetry_t *meter_telemetry(void) {
+    return &telemetry;
+}
+
+void meter_capture_mean(uint8_t channel, const uint16_t *table_q4) {
+    capture = METER_CAPTURE_NONE;
+    capture_channel = channel;
+    capture_table_q4 = table_q4;
+    capture_sum_q4 = 0;
+    capture_n = 0;
+    capture = METER_CAPTURE_MEAN;
+}
+
+// Média em Q4 quando a captura completa METER_CAPTURE_SAMPLES amostras
+bool meter_capture_mean_done(uint32_t *mean_q4) {
+    if (capture != METER_CAPTURE_MEAN || capture_n < METER_CAPTURE_SAMPLES)
+        return false;
+    capture = METER_CAPTURE_NONE;
+    *mean_q4 = (capture_sum_q4 + capture_n / 2) / capture_n;
+    return true;
+}
+
+// `hist` (ADC_CAL_CODES contadores, zerados por quem chama) acumula até
+// meter_capture_stop
+void meter_capture_hist(uint8_t channel, uint32_t *hist) {
+    capture = METER_CAPTURE_NONE;
+    capture_channel = channel;
+    capture_hist = hist;
+    capture = METER_CAPTURE_HIST;
+}
+
+void meter_capture_stop(void) {
+    capture = METER_CAPTURE_NONE;
+}
+
+meter_capture_t meter_capture_kind(void) {
+    return capture;
+}
+
+uint32_t meter_blocks(void) {
+    return blocks_received;
+}
+
+uint32_t meter_first_reading_us(void) {
+    return first_reading_us;
+}
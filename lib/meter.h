@@ -0,0 +1,124 @@
+#ifndef METER_H
+#define METER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "adc_cal.h"
+#include "adc_dma.h"
+#include "binning.h"
+#include "scheduler.h"
+#include "telemetry.h"
+
+// Caminho de medição do ohmímetro, no core 1
+//
+// Os blocos entregues pelo DMA são separados por canal e filtrados no IRQ
+// (ponta aberta/curto, filtro robusto, continuidade e capturas de
+// calibração); a tarefa de aquisição converte o que foi aceito em R_x,
+// decide o valor comercial e publica uma meter_reading_t por canal num
+// seqlock. O core 0 só conversa com o módulo pelas funções abaixo. O mesmo
+// código roda no firmware e no ohmimetro_replay, compilado com o CANAIS do
+// alvo.
+
+#ifndef CANAIS
+#define CANAIS 1 // Divisores em varredura, 1 a 3 (OHMIMETRO_CANAIS no CMake)
+#endif
+#if CANAIS < 1 || CANAIS > ADC_CAL_CHANNELS
+#error "CANAIS deve ser de 1 a 3 (GPIO 26 a 28)"
+#endif
+
+#define METER_ADC_LAST_INPUT 2  // GPIO 28
+#define METER_ADC_FIRST_INPUT (METER_ADC_LAST_INPUT + 1 - CANAIS) // Varredura: GPIO 26, 27 e 28
+#define METER_CHANNEL_RATE_HZ 200000u // Por canal: bloco de 256 em ~1,3 ms
+// Taxa total do ADC: a de um canal vezes o número de canais, até o máximo do ADC
+#define METER_ADC_RATE_HZ (METER_CHANNEL_RATE_HZ * CANAIS < ADC_DMA_MAX_RATE_HZ ? \
+                           METER_CHANNEL_RATE_HZ * CANAIS : ADC_DMA_MAX_RATE_HZ)
+#define METER_SAMPLES_DEFAULT 0       // Amostras por leitura: 0 = adaptativo (acumula até decidir)
+#define METER_SAMPLES_MAX 32768       // Limite do modo adaptativo (~164 ms a 200 ksps)
+#define METER_CONTINUITY_LIMIT_OHM 30 // Abaixo disso há continuidade (bipe e matriz verde)
+#define METER_CAPTURE_SAMPLES 65536   // Amostras das capturas de média (offset e referência)
+
+// Leitura completa de um canal, publicada pelo core 1
+typedef struct {
+    uint32_t media_q8;       // Código médio do ADC (Q8)
+    uint32_t r_x_mohm;       // Resistência medida em mΩ (limitada à faixa suportada)
+    uint32_t closest_mohm;   // Valor comercial mais próximo na série selecionada (mΩ)
+    uint32_t incerteza_mohm; // ± em R_x com a confiança configurada
+    uint32_t amostras;       // Amostras usadas nesta leitura
+    uint8_t series;          // Série E usada (e_series_id_t)
+    uint8_t digits;          // Dígitos significativos (faixas antes do multiplicador)
+    uint8_t bands[3];
+    uint8_t multiplier;
+    uint8_t estado;          // Estado da ponta (probe_state_t)
+    // Modo de separação
+    uint8_t classe;          // Resultado desta peça (bin_class_t)
+    uint16_t pecas_min;      // Ritmo das últimas peças
+    int32_t desvio_ppm;      // Desvio desta peça em relação ao nominal
+    uint32_t nominal_mohm;   // Alvo (0 = ainda não ensinado)
+    uint32_t contagem[BIN_COUNT - 1]; // Peças por classe (OK, alto, baixo, errado)
+} meter_reading_t;
+
+typedef struct {
+    bool closed;
+    uint32_t delay_us;     // Do início do contato (ou da abertura) à última decisão
+    uint32_t delay_max_us; // Pior caso desde que a continuidade foi ligada
+} meter_continuity_t;
+
+typedef enum {
+    METER_CAPTURE_NONE,
+    METER_CAPTURE_MEAN, // Média das amostras corrigidas por uma tabela
+    METER_CAPTURE_HIST, // Ocorrência de cada código bruto
+} meter_capture_t;
+
+// Core 0, antes de lançar o core 1: a calibração fica com quem chama e é
+// lida por referência (meter_calibration_changed depois de mudá-la)
+void meter_init(const adc_cal_t *cal, const uint16_t *table_q4);
+// Core 1: estado inicial, tarefa de aquisição em `sched` e callback do DMA
+void meter_start(scheduler_t *sched);
+// Reinício como no começo de uma gravação, na fase e no bloco dados
+// (reprodução), e blocos perdidos pela gravação
+void meter_restart(uint8_t phase, uint32_t block);
+void meter_skip(uint32_t blocks, uint32_t samples_per_block);
+
+// Leitura mais recente de um canal e a versão do seqlock (0 = nenhuma)
+uint32_t meter_read(uint8_t channel, meter_reading_t *r);
+uint32_t meter_version(uint8_t channel);
+
+void meter_set_series(uint8_t series);
+uint8_t meter_series(void);
+void meter_set_samples(uint32_t samples);
+uint32_t meter_samples(void);
+void meter_set_binning(bool on);
+const binning_t *meter_binning(void);
+// Alvo e tolerância da separação (mΩ e décimos de %); 0 volta ao padrão: a
+// primeira peça ensina o alvo, a tolerância é a da série. As consultas dão o
+// que está valendo (o alvo ensinado, se for o caso; 0 antes da primeira peça).
+void meter_set_binning_target(uint32_t nominal_mohm, uint16_t tolerance_tenths);
+uint32_t meter_binning_nominal(void);
+uint16_t meter_binning_tolerance(void);
+void meter_set_continuity(bool on);
+meter_continuity_t meter_continuity(void);
+void meter_calibration_changed(void);
+
+// Telemetria e gravação de sessão (host/replay): o core 1 produz o anel, o
+// core 0 o esvazia. Os toques nos botões entram na gravação junto com o
+// bloco em que foram vistos; o modo de exibição vai no cabeçalho.
+void meter_set_streaming(bool on);
+void meter_set_recording(bool on);
+void meter_set_display_mode(uint8_t mode);
+void meter_touch(telemetry_event_type_t type, uint8_t value, uint32_t time_us);
+telemetry_t *meter_telemetry(void);
+
+// Capturas de calibração num canal: o core 0 arma, o IRQ acumula
+void meter_capture_mean(uint8_t channel, const uint16_t *table_q4);
+bool meter_capture_mean_done(uint32_t *mean_q4);
+void meter_capture_hist(uint8_t channel, uint32_t *hist);
+void meter_capture_stop(void);
+meter_capture_t meter_capture_kind(void);
+
+uint32_t meter_blocks(void);
+// Instante (desde o boot) da primeira leitura decidida: o estado da ponta
+// publicado no primeiro bloco, com ela aberta ou em curto, ou o primeiro
+// valor estável; 0 enquanto não houver
+uint32_t meter_first_reading_us(void);
+
+#endif
@@ -0,0 +1,61 @@
+#include "probe.h"
+#include "pico/platform.h"
+
+void probe_init(probe_t *p, uint16_t open_code, uint16_t short_code, uint32_t hold_us) {
+    p->state = PROBE_OPEN;
+    p->since_us = 0;
+    p->open_code = open_code;
+    p->short_code = short_code;
+    p->hold_us = hold_us;
+    p->has_stable = false;
+}
+
+// Classifica o bloco pelas primeiras amostras: basta uma fora dos extremos
+// para haver uma peça (o filtro decide o resto). Roda da SRAM, no IRQ do bloco.
+probe_level_t __not_in_flash_func(probe_level)(const probe_t *p, const uint16_t *samples, uint32_t count) {
+    uint32_t n = count < PROBE_FAST_SAMPLES ? count : PROBE_FAST_SAMPLES;
+    uint16_t min = 0x0FFF, max = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        uint16_t s = samples[i] & 0x0FFF;
+        if (s < min) min = s;
+        if (s > max) max = s;
+    }
+    if (n && min >= p->open_code)
+        return PROBE_LEVEL_OPEN;
+    if (n && max <= p->short_code)
+        return PROBE_LEVEL_SHORT;
+    return PROBE_LEVEL_PART;
+}
+
+static void probe_enter(probe_t *p, probe_state_t state, uint64_t now_us) {
+    p->state = state;
+    p->since_us = now_us;
+    if (state == PROBE_STABLE)
+        p->has_stable = true;
+    else if (state == PROBE_OPEN || state == PROBE_SHORT)
+        p->has_stable = false;
+}
+
+// Avança a máquina; retorna true se o estado mudou
+bool probe_update(probe_t *p, probe_level_t level, bool step, bool decided, uint64_t now_us) {
+    probe_state_t old = p->state;
+    switch (level) {
+    case PROBE_LEVEL_OPEN:
+        if (p->state == PROBE_STABLE || (p->state == PROBE_SETTLING && p->has_stable))
+            probe_enter(p, PROBE_HOLD, now_us);
+        else if (p->state == PROBE_SETTLING || (p->state == PROBE_HOLD && now_us - p->since_us >= p->hold_us))
+            probe_enter(p, PROBE_OPEN, now_us);
+        break;
+    case PROBE_LEVEL_SHORT:
+        if (p->state != PROBE_SHORT)
+            probe_enter(p, PROBE_SHORT, now_us);
+        break;
+    case PROBE_LEVEL_PART:
+        if (p->state == PROBE_OPEN || p->state == PROBE_SHORT || p->state == PROBE_HOLD || step)
+            probe_enter(p, PROBE_SETTLING, now_us);
+        if (p->state == PROBE_SETTLING && decided)
+            probe_enter(p, PROBE_STABLE, now_us);
+        break;
+    }
+    return p->state != old;
+}
@@ -0,0 +1,45 @@
+#ifndef PROBE_H
+#define PROBE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Máquina de estados da ponta de prova
+//
+// ABERTO e CURTO são reconhecidos pelas primeiras amostras de cada bloco
+// (o resto do bloco nem passa pelo filtro). Com uma peça conectada o estado
+// vai de ESTABILIZANDO para ESTAVEL quando o valor comercial fica decidido;
+// uma troca de peça (degrau) volta a ESTABILIZANDO. Ao retirar uma peça já
+// estável a última leitura fica congelada (HOLD) por hold_us, mesmo que o
+// contato tenha trepidado (ESTABILIZANDO) na retirada.
+
+typedef enum {
+    PROBE_OPEN,
+    PROBE_SHORT,
+    PROBE_SETTLING,
+    PROBE_STABLE,
+    PROBE_HOLD
+} probe_state_t;
+
+typedef enum {
+    PROBE_LEVEL_PART,
+    PROBE_LEVEL_OPEN,
+    PROBE_LEVEL_SHORT
+} probe_level_t;
+
+#define PROBE_FAST_SAMPLES 16 // Amostras usadas para reconhecer aberto/curto
+
+typedef struct {
+    probe_state_t state;
+    uint64_t since_us;      // Entrada no estado atual
+    uint16_t open_code;     // Todas as amostras >= open_code: ponta aberta
+    uint16_t short_code;    // Todas as amostras <= short_code: curto
+    uint32_t hold_us;
+    bool has_stable;        // Há leitura estável para congelar no HOLD
+} probe_t;
+
+void probe_init(probe_t *p, uint16_t open_code, uint16_t short_code, uint32_t hold_us);
+probe_level_t probe_level(const probe_t *p, const uint16_t *samples, uint32_t count);
+bool probe_update(probe_t *p, probe_level_t level, bool step, bool decided, uint64_t now_us);
+
+#endif
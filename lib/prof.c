@@ -0,0 +1,86 @@
+#include "prof.h"
+
+#if PROF_ENABLED
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+
+typedef struct {
+    uint32_t ring[PROF_RING];
+    uint32_t head;
+    uint32_t count;
+    uint32_t min, max;
+    uint64_t sum;
+} prof_stats_t;
+
+static prof_stats_t prof_stats[PROF_STAGE_COUNT];
+
+static const char *const prof_names[PROF_STAGE_COUNT] = {
+    "aquisicao", "conversao", "busca", "render", "i2c", "leds",
+};
+
+// SysTick livre com o clock do processador; cada core tem o seu
+void prof_init_core(void) {
+    systick_hw->rvr = 0xFFFFFF;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5; // ENABLE | CLKSOURCE (processador), sem IRQ
+}
+
+uint32_t prof_now(void) {
+    return systick_hw->cvr;
+}
+
+void prof_record(prof_stage_t stage, uint32_t cycles) {
+    prof_stats_t *s = &prof_stats[stage];
+    s->ring[s->head] = cycles;
+    s->head = (s->head + 1) % PROF_RING;
+    if (s->count == 0 || cycles < s->min)
+        s->min = cycles;
+    if (cycles > s->max)
+        s->max = cycles;
+    s->sum += cycles;
+    s->count++;
+}
+
+void prof_record_us(prof_stage_t stage, uint32_t us) {
+    prof_record(stage, us * (clock_get_hz(clk_sys) / 1000000u));
+}
+
+void prof_reset(void) {
+    memset(prof_stats, 0, sizeof(prof_stats));
+}
+
+// p99 das últimas PROF_RING amostras (ordenação por inserção de uma cópia)
+static uint32_t prof_p99(const prof_stats_t *s) {
+    uint32_t n = s->count < PROF_RING ? s->count : PROF_RING;
+    if (n == 0)
+        return 0;
+    uint32_t v[PROF_RING];
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t x = s->ring[i];
+        uint32_t j = i;
+        while (j > 0 && v[j - 1] > x) {
+            v[j] = v[j - 1];
+            j--;
+        }
+        v[j] = x;
+    }
+    return v[(n * 99 + 99) / 100 - 1];
+}
+
+// CSV em ciclos de clk_sys: etapa,n,min,media,p99,max
+void prof_dump_csv(void) {
+    printf("# prof clk_hz=%lu\n", (unsigned long)clock_get_hz(clk_sys));
+    printf("etapa,n,min,media,p99,max\n");
+    for (int i = 0; i < PROF_STAGE_COUNT; i++) {
+        const prof_stats_t *s = &prof_stats[i];
+        uint32_t mean = s->count ? (uint32_t)(s->sum / s->count) : 0;
+        printf("%s,%lu,%lu,%lu,%lu,%lu\n", prof_names[i], (unsigned long)s->count, (unsigned long)s->min,
+               (unsigned long)mean, (unsigned long)prof_p99(s), (unsigned long)s->max);
+    }
+}
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef PROF_H
+#define PROF_H
+
+#include <stdint.h>
+
+// Instrumentação por etapa do pipeline, com o contador do SysTick (ciclos
+// de clk_sys, 24 bits: etapas de até ~134 ms a 125 MHz)
+//
+// Cada etapa guarda min/max/soma desde o último reset e as últimas
+// PROF_RING durações, de onde sai o p99. Cada etapa tem um único escritor
+// (um core ou um IRQ); o dump pode ver uma amostra pela metade, o que é
+// aceitável para estatística. Sem PROF_ENABLED as macros somem e nada é
+// compilado, então as marcações podem ficar no código de produção.
+
+typedef enum {
+    PROF_ACQUISITION,  // IRQ do DMA: classificação da ponta + filtro do bloco
+    PROF_CONVERSION,   // Estatística, R_x e incerteza
+    PROF_LOOKUP,       // Valor comercial (tabela) e faixas
+    PROF_RENDER,       // Desenho da tela no framebuffer
+    PROF_I2C_FLUSH,    // Envio do quadro por DMA/I2C até o STOP
+    PROF_LED_FLUSH,    // Atualização da matriz de LEDs
+    PROF_STAGE_COUNT
+} prof_stage_t;
+
+#define PROF_RING 128
+
+#ifndef PROF_ENABLED
+#define PROF_ENABLED 0
+#endif
+
+#if PROF_ENABLED
+
+void prof_init_core(void);
+uint32_t prof_now(void);
+void prof_record(prof_stage_t stage, uint32_t cycles);
+void prof_record_us(prof_stage_t stage, uint32_t us);
+void prof_reset(void);
+void prof_dump_csv(void);
+
+#define PROF_START(t) uint32_t t = prof_now()
+#define PROF_END(stage, t) prof_record(stage, (t - prof_now()) & 0xFFFFFFu) // SysTick conta para baixo
+#define PROF_RECORD_US(stage, us) prof_record_us(stage, us)
+
+#else
+
+static inline void prof_init_core(void) {}
+static inline void prof_reset(void) {}
+static inline void prof_dump_csv(void) {}
+
+#define PROF_START(t)
+#define PROF_END(stage, t) ((void)0)
+#define PROF_RECORD_US(stage, us) ((void)0)
+
+#endif
+
+#endif
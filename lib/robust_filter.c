@@ -0,0 +1,176 @@
+#include "robust_filter.h"
+#include <stddef.h>
+#include "pico/platform.h"
+
+void robust_filter_init(robust_filter_t *f, uint8_t iir_shift, uint16_t min_dev_q4, uint8_t step_groups) {
+    f->iir_shift = iir_shift;
+    f->min_dev_q4 = min_dev_q4;
+    f->step_groups = step_groups > ROBUST_STEP_MAX ? ROBUST_STEP_MAX : step_groups;
+    f->correction_q4 = NULL;
+    f->outliers = 0;
+    f->steps = 0;
+    robust_filter_reset(f);
+}
+
+void robust_filter_reset(robust_filter_t *f) {
+    f->head = 0;
+    f->count = 0;
+    f->pending_count = 0;
+    f->pending_side = 0;
+    f->estimate_q8 = 0;
+    f->valid = false;
+}
+
+// Remove `old` (se houver) e insere `value` na janela ordenada, deslocando
+// só o trecho entre as duas posições
+static void robust_filter_insert(robust_filter_t *f, uint16_t value) {
+    int n = f->count;
+    if (n == ROBUST_WINDOW) {
+        uint16_t old = f->ring[f->head];
+        int i = 0;
+        while (f->sorted[i] != old)
+            i++;
+        for (; i < n - 1; i++)
+            f->sorted[i] = f->sorted[i + 1];
+        n--;
+    } else {
+        f->count++;
+    }
+    int i = n;
+    while (i > 0 && f->sorted[i - 1] > value) {
+        f->sorted[i] = f->sorted[i - 1];
+        i--;
+    }
+    f->sorted[i] = value;
+    f->ring[f->head] = value;
+    f->head = (f->head + 1) % ROBUST_WINDOW;
+}
+
+// Média interquartil da janela (descarta 1/4 de cada lado), em Q8
+static int32_t robust_filter_iqm_q8(const robust_filter_t *f) {
+    int trim = f->count / 4;
+    int n = f->count - 2 * trim;
+    uint32_t sum = 0;
+    for (int i = trim; i < trim + n; i++)
+        sum += f->sorted[i];
+    return (int32_t)(((sum << 4) + n / 2) / n);
+}
+
+// Reinicia a janela com os grupos descartados em sequência (peça nova)
+static void robust_filter_step(robust_filter_t *f) {
+    uint8_t n = f->pending_count;
+    uint16_t groups[ROBUST_STEP_MAX];
+    for (uint8_t i = 0; i < n; i++)
+        groups[i] = f->pending[i];
+    robust_filter_reset(f);
+    for (uint8_t i = 0; i < n; i++)
+        robust_filter_insert(f, groups[i]);
+    f->estimate_q8 = robust_filter_iqm_q8(f);
+    f->valid = true;
+    f->steps++;
+}
+
+// Entrega um grupo (média de ROBUST_GROUP amostras em Q4). Retorna true se o
+// grupo foi aceito na janela (inclusive quando completou um degrau).
+bool robust_filter_push(robust_filter_t *f, uint16_t group_q4) {
+    if (f->count >= 4) {
+        uint16_t median = f->sorted[f->count / 2];
+        uint16_t iqr = f->sorted[(3 * f->count) / 4] - f->sorted[f->count / 4];
+        // Limite proporcional ao espalhamento da janela, mas com teto: durante
+        // o contato ruim o IQR cresce e não pode passar a aceitar qualquer grupo
+        uint32_t limit = 2u * iqr;
+        if (limit < f->min_dev_q4)
+            limit = f->min_dev_q4;
+        if (limit > 4u * f->min_dev_q4)
+            limit = 4u * f->min_dev_q4;
+        int side = group_q4 > median + limit ? 1 : (group_q4 + limit < median ? -1 : 0);
+        if (side) {
+            f->outliers++;
+            if (side != f->pending_side)
+                f->pending_count = 0;
+            f->pending_side = side;
+            f->pending[f->pending_count++] = group_q4;
+            if (f->pending_count >= f->step_groups) {
+                robust_filter_step(f);
+                return true;
+            }
+            return false;
+        }
+    }
+    f->pending_count = 0;
+    f->pending_side = 0;
+    robust_filter_insert(f, group_q4);
+
+    int32_t x = robust_filter_iqm_q8(f);
+    if (!f->valid) {
+        f->estimate_q8 = x;
+        f->valid = true;
+    } else {
+        f->estimate_q8 += (x - f->estimate_q8) >> f->iir_shift;
+    }
+    return true;
+}
+
+// Tabela de linearização aplicada a cada amostra (NULL volta ao ADC ideal)
+void robust_filter_set_correction(robust_filter_t *f, const uint16_t *table_q4) {
+    f->correction_q4 = table_q4;
+}
+
+// Soma e soma dos quadrados de um grupo em códigos; com a tabela, somadas em
+// Q4/Q8 e arredondadas para códigos (erro < 1/32 de código na média do grupo).
+// Laço por amostra do IRQ do bloco: fica na SRAM, junto com robust_filter_block.
+static void __not_in_flash_func(robust_filter_group)(const robust_filter_t *f, const uint16_t *samples, uint32_t *sum, uint64_t *sum_sq) {
+    uint32_t s1 = 0;
+    uint64_t s2 = 0;
+    if (f->correction_q4) {
+        for (uint32_t i = 0; i < ROBUST_GROUP; i++) {
+            uint32_t c = f->correction_q4[samples[i] & 0x0FFF];
+            s1 += c;
+            s2 += c * c; // 65535² ainda cabe em 32 bits
+        }
+        *sum = (s1 + 8) >> 4;
+        *sum_sq = (s2 + 128) >> 8;
+        return;
+    }
+    for (uint32_t i = 0; i < ROBUST_GROUP; i++) {
+        uint32_t s = samples[i] & 0x0FFF;
+        s1 += s;
+        s2 += s * s;
+    }
+    *sum = s1;
+    *sum_sq = s2;
+}
+
+// Processa um bloco do DMA. Grupos aceitos são somados em `accepted` (soma e
+// soma dos quadrados por amostra), para a estimativa de incerteza ignorar os
+// picos. Retorna true se houve degrau (peça nova) no bloco; nesse caso
+// `accepted` recomeça com os grupos que formaram o degrau.
+bool __not_in_flash_func(robust_filter_block)(robust_filter_t *f, const uint16_t *samples, uint32_t count, stats_t *accepted) {
+    bool step = false;
+    for (uint32_t g = 0; g + ROBUST_GROUP <= count; g += ROBUST_GROUP) {
+        uint32_t sum;
+        uint64_t sum_sq;
+        robust_filter_group(f, &samples[g], &sum, &sum_sq);
+        uint32_t steps = f->steps;
+        bool ok = robust_filter_push(f, (uint16_t)sum);
+        if (f->steps != steps) {
+            // A janela nova são os descartes em sequência (o último entra
+            // abaixo, como aceito): todos contam para a incerteza
+            step = true;
+            if (accepted) {
+                stats_reset(accepted);
+                for (uint8_t i = 0; i + 1 < f->count; i++)
+                    stats_add_block(accepted, ROBUST_GROUP, f->pending[i], f->pending_sq[i]);
+            }
+        } else if (!ok) {
+            f->pending_sq[f->pending_count - 1] = (uint32_t)sum_sq;
+        }
+        if (ok && accepted)
+            stats_add_block(accepted, ROBUST_GROUP, sum, sum_sq);
+    }
+    return step;
+}
+
+uint32_t robust_filter_estimate_q8(const robust_filter_t *f) {
+    return f->estimate_q8 > 0 ? (uint32_t)f->estimate_q8 : 0;
+}
@@ -0,0 +1,51 @@
+#ifndef ROBUST_FILTER_H
+#define ROBUST_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "stats.h"
+
+// Filtro robusto incremental para as amostras do ADC
+//
+// As amostras são agrupadas em médias de ROBUST_GROUP (código em Q4) e cada
+// grupo passa por uma janela deslizante ordenada. Grupos longe da mediana
+// (mais que 2 * IQR, limitado entre min_dev e 4 * min_dev) são descartados como picos ou contato
+// ruim; vários descartes seguidos do mesmo lado indicam outra peça (degrau)
+// e reiniciam a janela com os grupos novos. A saída é a média interquartil
+// da janela seguida de um IIR de primeira ordem. Com uma tabela de correção
+// (4096 entradas, Q4) cada amostra é linearizada antes de entrar no grupo.
+//
+// Só inteiros e sem estado global: o mesmo vetor de amostras sempre produz
+// a mesma saída, no firmware ou no host.
+
+#define ROBUST_GROUP 16        // Amostras por grupo (soma de 16 códigos cabe em Q4)
+#define ROBUST_WINDOW 32       // Grupos na janela (512 amostras)
+#define ROBUST_STEP_MAX 8      // Máximo de grupos consecutivos para um degrau
+
+typedef struct {
+    uint16_t ring[ROBUST_WINDOW];    // Grupos em ordem de chegada (Q4)
+    uint16_t sorted[ROBUST_WINDOW];  // Mesmos grupos ordenados
+    uint8_t head, count;
+    uint16_t pending[ROBUST_STEP_MAX]; // Descartes consecutivos do mesmo lado
+    uint32_t pending_sq[ROBUST_STEP_MAX]; // Soma dos quadrados de cada um (robust_filter_block)
+    uint8_t pending_count;
+    int8_t pending_side;
+    int32_t estimate_q8;             // Saída do IIR (código em Q8)
+    bool valid;
+    // Configuração
+    uint8_t iir_shift;               // y += (x - y) >> iir_shift
+    uint16_t min_dev_q4;             // Desvio mínimo para descartar um grupo
+    uint8_t step_groups;             // Descartes seguidos que caracterizam um degrau
+    const uint16_t *correction_q4;   // Código bruto -> código corrigido (Q4); NULL = ADC ideal
+    // Contadores
+    uint32_t outliers, steps;
+} robust_filter_t;
+
+void robust_filter_init(robust_filter_t *f, uint8_t iir_shift, uint16_t min_dev_q4, uint8_t step_groups);
+void robust_filter_reset(robust_filter_t *f);
+void robust_filter_set_correction(robust_filter_t *f, const uint16_t *table_q4);
+bool robust_filter_push(robust_filter_t *f, uint16_t group_q4);
+bool robust_filter_block(robust_filter_t *f, const uint16_t *samples, uint32_t count, stats_t *accepted);
+uint32_t robust_filter_estimate_q8(const robust_filter_t *f);
+
+#endif
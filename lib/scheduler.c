@@ -0,0 +1,107 @@
+#include "scheduler.h"
+
+void sched_init(scheduler_t *sched, alarm_pool_t *pool) {
+    sched->count = 0;
+    sched->pool = pool;
+    sched->alarm = 0;
+    sched->alarm_at = 0;
+    sched->sleeps = 0;
+}
+
+// Retorna o índice da tarefa, ou -1 se a tabela estiver cheia
+int sched_add(scheduler_t *sched, const char *name, sched_task_fn_t fn, void *ctx, uint32_t period_us) {
+    if (sched->count >= SCHED_MAX_TASKS)
+        return -1;
+    sched_task_t *task = &sched->tasks[sched->count];
+    task->name = name;
+    task->fn = fn;
+    task->ctx = ctx;
+    task->period_us = period_us;
+    task->next_us = time_us_64() + period_us;
+    task->posted = false;
+    task->runs = 0;
+    task->max_us = 0;
+    return sched->count++;
+}
+
+// Pode ser chamada de IRQ: o IRQ em si já acorda o core do __wfi()
+void sched_post(scheduler_t *sched, int task) {
+    if (task >= 0 && task < sched->count)
+        sched->tasks[task].posted = true;
+}
+
+void sched_set_period(scheduler_t *sched, int task, uint32_t period_us) {
+    if (task < 0 || task >= sched->count)
+        return;
+    sched->tasks[task].period_us = period_us;
+    sched->tasks[task].next_us = time_us_64() + period_us;
+}
+
+static int64_t sched_alarm_callback(alarm_id_t id, void *user_data) {
+    scheduler_t *sched = user_data;
+    sched->alarm = 0;
+    return 0; // Só serve para acordar o core
+}
+
+// Arma o alarme para `deadline` se não houver um alarme mais cedo pendente.
+// Um alarme cujo horário já passou é tratado como disparado, mesmo que o
+// callback tenha rodado antes de `alarm` ser atualizado aqui.
+static void sched_arm(scheduler_t *sched, uint64_t deadline) {
+    if (sched->alarm > 0 && sched->alarm_at <= deadline && sched->alarm_at > time_us_64())
+        return;
+    if (sched->alarm > 0)
+        alarm_pool_cancel_alarm(sched->pool, sched->alarm);
+    sched->alarm_at = deadline;
+    alarm_id_t id = alarm_pool_add_alarm_at(sched->pool, from_us_since_boot(deadline), sched_alarm_callback, sched, true);
+    sched->alarm = id > 0 ? id : 0;
+}
+
+// Executa as tarefas prontas e dorme até o próximo prazo ou evento
+void sched_run_once(scheduler_t *sched) {
+    uint64_t now = time_us_64();
+    for (uint8_t i = 0; i < sched->count; i++) {
+        sched_task_t *task = &sched->tasks[i];
+        bool due = task->period_us && now >= task->next_us;
+        if (!task->posted && !due)
+            continue;
+        task->posted = false;
+        if (due) {
+            task->next_us += task->period_us;
+            if (task->next_us <= now) // Atrasou mais de um período: não acumula
+                task->next_us = now + task->period_us;
+        }
+        uint64_t start = time_us_64();
+        task->fn(task->ctx);
+        uint32_t elapsed = time_us_64() - start;
+        if (elapsed > task->max_us)
+            task->max_us = elapsed;
+        task->runs++;
+        now = time_us_64();
+    }
+
+    uint64_t deadline = UINT64_MAX;
+    for (uint8_t i = 0; i < sched->count; i++) {
+        sched_task_t *task = &sched->tasks[i];
+        if (task->period_us && task->next_us < deadline)
+            deadline = task->next_us;
+    }
+    if (deadline != UINT64_MAX)
+        sched_arm(sched, deadline);
+
+    // Com as interrupções mascaradas o __wfi() ainda acorda com um IRQ
+    // pendente, então não se perde um evento que chegue entre o teste e o sono
+    uint32_t status = save_and_disable_interrupts();
+    bool pending = false;
+    for (uint8_t i = 0; i < sched->count && !pending; i++)
+        pending = sched->tasks[i].posted;
+    if (!pending && time_us_64() < deadline) {
+        sched->sleeps++;
+        __wfi();
+    }
+    restore_interrupts(status);
+}
+
+void sched_run(scheduler_t *sched) {
+    while (true)
+        sched_run_once(sched);
+}
@@ -0,0 +1,44 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "pico/stdlib.h"
+
+// Escalonador cooperativo sem tick fixo
+//
+// Cada tarefa tem um período (0 = só executa quando sinalizada) e pode ser
+// sinalizada de um IRQ com sched_post(). Entre eventos o core dorme em
+// __wfi(); um único alarme é armado para o próximo prazo, então não há
+// interrupções periódicas quando nada precisa rodar.
+
+#define SCHED_MAX_TASKS 8
+
+typedef void (*sched_task_fn_t)(void *ctx);
+
+typedef struct {
+    const char *name;
+    sched_task_fn_t fn;
+    void *ctx;
+    uint32_t period_us;     // 0 = tarefa apenas por evento
+    uint64_t next_us;       // Próxima execução periódica
+    volatile bool posted;   // Sinalizada por IRQ ou por outra tarefa
+    uint32_t runs;
+    uint32_t max_us;        // Maior duração observada
+} sched_task_t;
+
+typedef struct {
+    sched_task_t tasks[SCHED_MAX_TASKS];
+    uint8_t count;
+    alarm_pool_t *pool;     // Alarmes disparam no core dono do pool
+    volatile alarm_id_t alarm;
+    uint64_t alarm_at;
+    uint32_t sleeps;
+} scheduler_t;
+
+void sched_init(scheduler_t *sched, alarm_pool_t *pool);
+int sched_add(scheduler_t *sched, const char *name, sched_task_fn_t fn, void *ctx, uint32_t period_us);
+void sched_post(scheduler_t *sched, int task);
+void sched_set_period(scheduler_t *sched, int task, uint32_t period_us);
+void sched_run_once(scheduler_t *sched);
+void sched_run(scheduler_t *sched);
+
+#endif
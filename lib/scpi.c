@@ -0,0 +1,252 @@
+#include "scpi.h"
+#include <string.h>
+
+static inline bool is_space(char c) {
+    return c == ' ' || c == '\t';
+}
+
+static inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline bool is_lower(char c) {
+    return c >= 'a' && c <= 'z';
+}
+
+static inline char to_upper(char c) {
+    return is_lower(c) ? c - 'a' + 'A' : c;
+}
+
+static const char *skip_spaces(const char *p) {
+    while (is_space(*p))
+        p++;
+    return p;
+}
+
+void scpi_init(scpi_t *s, const scpi_command_t *commands, uint8_t count) {
+    memset(s, 0, sizeof(*s));
+    s->commands = commands;
+    s->count = count;
+}
+
+// Acumula um caractere; true quando a linha está completa e deve ir para
+// scpi_run(). Com uma linha pendente o caractere não é aceito: quem chama
+// para de ler a entrada enquanto scpi_busy().
+bool scpi_feed(scpi_t *s, char c) {
+    if (s->ready)
+        return true;
+    if (c == '\r' || c == '\n') {
+        if (s->len == 0 && !s->overrun)
+            return false; // Linha vazia (ou o '\n' de um "\r\n")
+        s->line[s->len] = '\0';
+        s->pos = 0;
+        s->ready = true;
+        return true;
+    }
+    if (s->len < SCPI_LINE_MAX - 1)
+        s->line[s->len++] = c;
+    else
+        s->overrun = true;
+    return false;
+}
+
+bool scpi_busy(const scpi_t *s) {
+    return s->ready;
+}
+
+void scpi_defer(scpi_t *s) {
+    s->deferred = true;
+}
+
+// Um nível do padrão ("MEASure") contra um da entrada: a forma curta (as
+// maiúsculas do padrão) ou a longa, sem diferenciar a caixa
+static bool match_mnemonic(const char *pattern, size_t plen, const char *in, size_t len) {
+    size_t short_len = 0;
+    while (short_len < plen && !is_lower(pattern[short_len]))
+        short_len++;
+    if (len == 0 || (len != short_len && len != plen))
+        return false;
+    for (size_t i = 0; i < len; i++) {
+        if (to_upper(in[i]) != to_upper(pattern[i]))
+            return false;
+    }
+    return true;
+}
+
+// Cabeçalho da entrada (sem os parâmetros) contra um padrão; o ':' inicial é
+// opcional e a consulta ('?') tem de bater
+bool scpi_match(const char *pattern, const char *header, size_t len) {
+    if (len && header[0] == ':') {
+        header++;
+        len--;
+    }
+    size_t plen = strlen(pattern);
+    bool query = len && header[len - 1] == '?';
+    bool pattern_query = plen && pattern[plen - 1] == '?';
+    if (query != pattern_query)
+        return false;
+    len -= query;
+    plen -= pattern_query;
+    while (true) {
+        size_t pn = 0, n = 0;
+        while (pn < plen && pattern[pn] != ':')
+            pn++;
+        while (n < len && header[n] != ':')
+            n++;
+        if (!match_mnemonic(pattern, pn, header, n))
+            return false;
+        if (pn == plen || n == len)
+            return pn == plen && n == len;
+        pattern += pn + 1;
+        plen -= pn + 1;
+        header += n + 1;
+        len -= n + 1;
+    }
+}
+
+static void execute(scpi_t *s, const char *command) {
+    command = skip_spaces(command);
+    if (*command == '\0')
+        return; // Comando vazio: ";;" ou ';' no fim
+    size_t len = 0;
+    while (command[len] && !is_space(command[len]))
+        len++;
+    const char *params = skip_spaces(command + len);
+    for (uint8_t i = 0; i < s->count; i++) {
+        if (scpi_match(s->commands[i].pattern, command, len)) {
+            s->commands[i].fn(s, params);
+            return;
+        }
+    }
+    scpi_error(s, SCPI_ERR_UNDEFINED_HEADER);
+}
+
+// Executa a linha completa a partir de onde parou; false se um comando
+// pediu mais tempo (o resto roda na próxima chamada)
+bool scpi_run(scpi_t *s) {
+    if (!s->ready)
+        return true;
+    if (s->overrun) {
+        scpi_error(s, SCPI_ERR_INPUT_OVERRUN);
+    } else {
+        while (s->pos < s->len) {
+            char *command = &s->line[s->pos];
+            char *end = strchr(command, ';');
+            if (end) {
+                *end = '\0';
+                s->pos = end - s->line + 1;
+            } else {
+                s->pos = s->len;
+            }
+            execute(s, command);
+            if (s->deferred) {
+                s->deferred = false;
+                return false;
+            }
+        }
+    }
+    s->len = 0;
+    s->pos = 0;
+    s->ready = false;
+    s->overrun = false;
+    return true;
+}
+
+// Fila cheia: o erro mais recente vira "Queue overflow", como no padrão
+void scpi_error(scpi_t *s, int16_t code) {
+    if (s->error_count == SCPI_ERROR_QUEUE) {
+        s->errors[(s->error_head + SCPI_ERROR_QUEUE - 1) % SCPI_ERROR_QUEUE] = SCPI_ERR_QUEUE_OVERFLOW;
+        return;
+    }
+    s->errors[(s->error_head + s->error_count++) % SCPI_ERROR_QUEUE] = code;
+}
+
+// Erro mais antigo da fila; 0 se vazia
+int16_t scpi_pop_error(scpi_t *s) {
+    if (s->error_count == 0)
+        return 0;
+    int16_t code = s->errors[s->error_head];
+    s->error_head = (s->error_head + 1) % SCPI_ERROR_QUEUE;
+    s->error_count--;
+    return code;
+}
+
+const char *scpi_error_text(int16_t code) {
+    switch (code) {
+    case 0: return "No error";
+    case SCPI_ERR_COMMAND: return "Command error";
+    case SCPI_ERR_DATA_TYPE: return "Data type error";
+    case SCPI_ERR_PARAMETER_NOT_ALLOWED: return "Parameter not allowed";
+    case SCPI_ERR_MISSING_PARAMETER: return "Missing parameter";
+    case SCPI_ERR_UNDEFINED_HEADER: return "Undefined header";
+    case SCPI_ERR_EXECUTION: return "Execution error";
+    case SCPI_ERR_OUT_OF_RANGE: return "Data out of range";
+    case SCPI_ERR_ILLEGAL_VALUE: return "Illegal parameter value";
+    case SCPI_ERR_QUEUE_OVERFLOW: return "Queue overflow";
+    case SCPI_ERR_INPUT_OVERRUN: return "Input buffer overrun";
+    case SCPI_ERR_TIMEOUT: return "Time out error";
+    default: return "Error";
+    }
+}
+
+// Depois de um parâmetro: espaços e a vírgula até o próximo
+static bool next_param(const char **p, const char *q) {
+    q = skip_spaces(q);
+    if (*q == ',')
+        q = skip_spaces(q + 1);
+    else if (*q != '\0')
+        return false;
+    *p = q;
+    return true;
+}
+
+bool scpi_param_fixed(const char **p, uint8_t decimals, uint32_t *value) {
+    const char *q = skip_spaces(*p);
+    uint64_t v = 0;
+    bool digits = false;
+    while (is_digit(*q)) {
+        v = v * 10 + (*q++ - '0');
+        digits = true;
+        if (v > UINT32_MAX)
+            return false;
+    }
+    uint8_t places = 0;
+    if (*q == '.') {
+        for (q++; is_digit(*q); q++) {
+            if (places < decimals) {
+                v = v * 10 + (*q - '0');
+                places++;
+            }
+            digits = true;
+        }
+    }
+    if (!digits)
+        return false;
+    for (; places < decimals; places++)
+        v *= 10;
+    if (v > UINT32_MAX || !next_param(p, q))
+        return false;
+    *value = (uint32_t)v;
+    return true;
+}
+
+bool scpi_param_u32(const char **p, uint32_t *value) {
+    return scpi_param_fixed(p, 0, value);
+}
+
+// Palavra (letras, dígitos e '_'), copiada em maiúsculas
+bool scpi_param_word(const char **p, char *word, size_t size) {
+    const char *q = skip_spaces(*p);
+    size_t n = 0;
+    while ((is_digit(*q) || is_lower(*q) || (*q >= 'A' && *q <= 'Z') || *q == '_')) {
+        if (n + 1 >= size)
+            return false;
+        word[n++] = to_upper(*q++);
+    }
+    word[n] = '\0';
+    return n > 0 && next_param(p, q);
+}
+
+bool scpi_param_present(const char *p) {
+    return *skip_spaces(p) != '\0';
+}
@@ -0,0 +1,74 @@
+#ifndef SCPI_H
+#define SCPI_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Comandos de texto no estilo SCPI, uma linha por vez
+//
+// A linha chega caractere a caractere (scpi_feed, sem bloquear) e roda no
+// fim da linha: comandos separados por ';', níveis do cabeçalho por ':' e
+// parâmetros por ','. Cada nível do padrão tem a forma curta nas maiúsculas
+// ("MEASure?" aceita MEAS? e MEASURE?, sem diferenciar a caixa). Um comando
+// demorado (uma medida em lote) chama scpi_defer() e o resto da linha só
+// roda no próximo scpi_run(). Erros vão para uma fila lida por
+// SYSTem:ERRor?, com os códigos do padrão.
+
+#define SCPI_LINE_MAX 128
+#define SCPI_ERROR_QUEUE 8
+
+#define SCPI_ERR_COMMAND -100
+#define SCPI_ERR_DATA_TYPE -104
+#define SCPI_ERR_PARAMETER_NOT_ALLOWED -108
+#define SCPI_ERR_MISSING_PARAMETER -109
+#define SCPI_ERR_UNDEFINED_HEADER -113
+#define SCPI_ERR_EXECUTION -200
+#define SCPI_ERR_OUT_OF_RANGE -222
+#define SCPI_ERR_ILLEGAL_VALUE -224
+#define SCPI_ERR_QUEUE_OVERFLOW -350
+#define SCPI_ERR_INPUT_OVERRUN -363
+#define SCPI_ERR_TIMEOUT -365
+
+typedef struct scpi scpi_t;
+
+// `params` aponta para o primeiro parâmetro (ou para o fim do comando)
+typedef void (*scpi_fn_t)(scpi_t *s, const char *params);
+
+typedef struct {
+    const char *pattern;    // Ex.: "CALibration:RKNown?"
+    scpi_fn_t fn;
+} scpi_command_t;
+
+struct scpi {
+    const scpi_command_t *commands;
+    uint8_t count;
+    char line[SCPI_LINE_MAX];
+    uint8_t len;
+    uint8_t pos;            // Próximo comando da linha em execução
+    bool ready;             // Linha completa, ainda não terminada
+    bool overrun;           // Linha maior que SCPI_LINE_MAX: descartada
+    bool deferred;
+    int16_t errors[SCPI_ERROR_QUEUE];
+    uint8_t error_head, error_count;
+};
+
+void scpi_init(scpi_t *s, const scpi_command_t *commands, uint8_t count);
+bool scpi_feed(scpi_t *s, char c);
+bool scpi_run(scpi_t *s);
+void scpi_defer(scpi_t *s);
+bool scpi_busy(const scpi_t *s);
+bool scpi_match(const char *pattern, const char *header, size_t len);
+
+void scpi_error(scpi_t *s, int16_t code);
+int16_t scpi_pop_error(scpi_t *s);
+const char *scpi_error_text(int16_t code);
+
+// Parâmetros: cada leitura avança *p para o próximo. Números sem sinal, com
+// até `decimals` casas (escalados por 10^decimals, o resto é truncado).
+bool scpi_param_fixed(const char **p, uint8_t decimals, uint32_t *value);
+bool scpi_param_u32(const char **p, uint32_t *value);
+bool scpi_param_word(const char **p, char *word, size_t size);
+bool scpi_param_present(const char *p);
+
+#endif
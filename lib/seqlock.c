@@ -0,0 +1,47 @@
+#include <string.h>
+#include "seqlock.h"
+
+void seqlock_init(seqlock_t *lock) {
+    atomic_store_explicit(&lock->seq, 0, memory_order_relaxed);
+    for (int i = 0; i < SEQLOCK_MAX_WORDS; i++)
+        atomic_store_explicit(&lock->data[i], 0, memory_order_relaxed);
+}
+
+// Publica `size` bytes de `src` (até SEQLOCK_MAX_WORDS palavras, ver
+// SEQLOCK_ASSERT_FITS); deve ser chamada sempre pelo mesmo escritor
+void seqlock_write(seqlock_t *lock, const void *src, size_t size) {
+    uint32_t words[SEQLOCK_MAX_WORDS] = {0};
+    size_t n = (size + 3) / 4;
+    memcpy(words, src, size);
+
+    uint32_t seq = atomic_load_explicit(&lock->seq, memory_order_relaxed);
+    atomic_store_explicit(&lock->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    for (size_t i = 0; i < n; i++)
+        atomic_store_explicit(&lock->data[i], words[i], memory_order_relaxed);
+    atomic_store_explicit(&lock->seq, seq + 2, memory_order_release);
+}
+
+// Copia o último valor publicado para `dst` e retorna sua versão
+// (0 = nada publicado ainda)
+uint32_t seqlock_read(seqlock_t *lock, void *dst, size_t size) {
+    uint32_t words[SEQLOCK_MAX_WORDS];
+    size_t n = (size + 3) / 4;
+
+    uint32_t seq0, seq1;
+    do {
+        seq0 = atomic_load_explicit(&lock->seq, memory_order_acquire);
+        for (size_t i = 0; i < n; i++)
+            words[i] = atomic_load_explicit(&lock->data[i], memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        seq1 = atomic_load_explicit(&lock->seq, memory_order_relaxed);
+    } while ((seq0 & 1) || seq0 != seq1);
+
+    memcpy(dst, words, size);
+    return seq0 / 2;
+}
+
+// Versão atual, para saber se há um valor novo sem copiá-lo
+uint32_t seqlock_version(seqlock_t *lock) {
+    return atomic_load_explicit(&lock->seq, memory_order_acquire) / 2;
+}
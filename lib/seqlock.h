@@ -0,0 +1,33 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Snapshot publicado por um único escritor e lido sem trava por qualquer
+// número de leitores (ex.: core 1 escreve, core 0 lê).
+//
+// O contador é ímpar durante a escrita; o leitor repete a cópia se o
+// contador mudou ou estava ímpar. Só usa loads/stores atômicos e barreiras,
+// que existem no Cortex-M0+ (sem LDREX/STREX) e também no host.
+
+#define SEQLOCK_MAX_WORDS 16 // Tamanho máximo do dado publicado (64 bytes)
+
+// O tamanho não é limitado em tempo de execução: quem publica um tipo
+// verifica, junto da definição dele, que o tipo cabe
+#define SEQLOCK_ASSERT_FITS(type) \
+    _Static_assert(sizeof(type) <= SEQLOCK_MAX_WORDS * 4, #type " não cabe no seqlock (SEQLOCK_MAX_WORDS)")
+
+typedef struct {
+    _Atomic uint32_t seq;
+    _Atomic uint32_t data[SEQLOCK_MAX_WORDS];
+} seqlock_t;
+
+void seqlock_init(seqlock_t *lock);
+void seqlock_write(seqlock_t *lock, const void *src, size_t size);
+uint32_t seqlock_read(seqlock_t *lock, void *dst, size_t size);
+uint32_t seqlock_version(seqlock_t *lock);
+
+#endif
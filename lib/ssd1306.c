@@ -1,75 +1,396 @@
 #include "ssd1306.h"
 #include "font.h"
+#include <string.h>
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+// Custo fixo (em bytes no barramento) de abrir uma janela: endereço, controle
+// e 6 bytes de comando, mais endereço e controle da transferência de dados
+#define SSD1306_WINDOW_OVERHEAD 10
+
+static void ssd1306_dma_init(ssd1306_t *ssd);
+
+// Um display por firmware: buffers fora do heap, com tamanho conhecido no
+// link. O stream é lido pelo DMA em palavras de 16 bits.
+static uint8_t ssd1306_ram[SSD1306_BUFSIZE] __attribute__((aligned(4)));
+static uint8_t ssd1306_shadow[SSD1306_BUFSIZE] __attribute__((aligned(4)));
+static uint16_t ssd1306_stream[SSD1306_STREAM_WORDS] __attribute__((aligned(4)));
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
-  ssd->width = width;
-  ssd->height = height;
-  ssd->pages = height / 8U;
+  // Os buffers estáticos limitam o tamanho ao de WIDTH x HEIGHT
+  ssd->width = width < WIDTH ? width : WIDTH;
+  ssd->height = height < HEIGHT ? height : HEIGHT;
+  ssd->pages = ssd->height / 8U;
   ssd->address = address;
   ssd->i2c_port = i2c;
   ssd->bufsize = ssd->pages * ssd->width + 1;
-  ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd->ram_buffer = ssd1306_ram;
+  memset(ssd->ram_buffer, 0, ssd->bufsize);
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+  ssd->shadow = ssd1306_shadow;
+  memset(ssd->shadow, 0, ssd->bufsize);
+  // Pior caso: uma janela por página, cada uma com comandos e bytes de controle
+  ssd->stream_size = ssd->pages * (ssd->width + 1 + 7);
+  ssd->stream = ssd1306_stream;
+  ssd->stream_len = 0;
+  ssd->state = SSD1306_IDLE;
+  ssd->on_complete = NULL;
+  ssd->frames_sent = 0;
+  ssd->config_us = 0;
+  ssd->transfer_us = 0;
+  ssd->shadow_valid = false;
+  ssd->flush_bytes = 0;
+  ssd->total_bytes = 0;
+  for (uint8_t p = 0; p < SSD1306_MAX_PAGES; ++p) {
+    ssd->dirty_x0[p] = 0;
+    ssd->dirty_x1[p] = ssd->width - 1;
+  }
+  ssd1306_dma_init(ssd);
 }
 
 void ssd1306_config(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_DISP | 0x00);
-  ssd1306_command(ssd, SET_MEM_ADDR);
-  ssd1306_command(ssd, 0x01);
-  ssd1306_command(ssd, SET_DISP_START_LINE | 0x00);
-  ssd1306_command(ssd, SET_SEG_REMAP | 0x01);
-  ssd1306_command(ssd, SET_MUX_RATIO);
-  ssd1306_command(ssd, HEIGHT - 1);
-  ssd1306_command(ssd, SET_COM_OUT_DIR | 0x08);
-  ssd1306_command(ssd, SET_DISP_OFFSET);
-  ssd1306_command(ssd, 0x00);
-  ssd1306_command(ssd, SET_COM_PIN_CFG);
-  ssd1306_command(ssd, 0x12);
-  ssd1306_command(ssd, SET_DISP_CLK_DIV);
-  ssd1306_command(ssd, 0x80);
-  ssd1306_command(ssd, SET_PRECHARGE);
-  ssd1306_command(ssd, 0xF1);
-  ssd1306_command(ssd, SET_VCOM_DESEL);
-  ssd1306_command(ssd, 0x30);
-  ssd1306_command(ssd, SET_CONTRAST);
-  ssd1306_command(ssd, 0xFF);
-  ssd1306_command(ssd, SET_ENTIRE_ON);
-  ssd1306_command(ssd, SET_NORM_INV);
-  ssd1306_command(ssd, SET_CHARGE_PUMP);
-  ssd1306_command(ssd, 0x14);
-  ssd1306_command(ssd, SET_DISP | 0x01);
+  static const uint8_t init_sequence[] = {
+    SET_DISP | 0x00,
+    SET_MEM_ADDR, 0x01,
+    SET_DISP_START_LINE | 0x00,
+    SET_SEG_REMAP | 0x01,
+    SET_MUX_RATIO, HEIGHT - 1,
+    SET_COM_OUT_DIR | 0x08,
+    SET_DISP_OFFSET, 0x00,
+    SET_COM_PIN_CFG, 0x12,
+    SET_DISP_CLK_DIV, 0x80,
+    SET_PRECHARGE, 0xF1,
+    SET_VCOM_DESEL, 0x30,
+    SET_CONTRAST, 0xFF,
+    SET_ENTIRE_ON,
+    SET_NORM_INV,
+    SET_CHARGE_PUMP, 0x14,
+    SET_DISP | 0x01
+  };
+  uint32_t start = time_us_32();
+  ssd1306_cmd_list_t list;
+  ssd1306_cmd_list_init(&list);
+  ssd1306_cmd_list_add_bytes(&list, init_sequence, sizeof(init_sequence));
+  ssd1306_cmd_list_send(ssd, &list);
+  ssd->config_us = time_us_32() - start;
+}
+
+// Escritas bloqueantes (configuração) esperam o fim de uma transferência por DMA
+static void ssd1306_write(ssd1306_t *ssd, const uint8_t *data, size_t len) {
+  ssd1306_wait(ssd);
+  i2c_write_blocking(ssd->i2c_port, ssd->address, data, len, false);
+  ssd->total_bytes += len;
 }
 
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   ssd->port_buffer[1] = command;
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->port_buffer,
-    2,
-    false
-  );
+  ssd1306_write(ssd, ssd->port_buffer, 2);
+}
+
+void ssd1306_cmd_list_init(ssd1306_cmd_list_t *list) {
+  list->buffer[0] = 0x00;
+  list->len = 0;
+}
+
+bool ssd1306_cmd_list_add(ssd1306_cmd_list_t *list, uint8_t command) {
+  if (list->len >= SSD1306_CMD_LIST_MAX)
+    return false;
+  list->buffer[++list->len] = command;
+  return true;
+}
+
+bool ssd1306_cmd_list_add_bytes(ssd1306_cmd_list_t *list, const uint8_t *commands, uint8_t count) {
+  if (list->len + count > SSD1306_CMD_LIST_MAX)
+    return false;
+  memcpy(&list->buffer[list->len + 1], commands, count);
+  list->len += count;
+  return true;
+}
+
+// Envia toda a lista numa única transação bloqueante
+void ssd1306_cmd_list_send(ssd1306_t *ssd, const ssd1306_cmd_list_t *list) {
+  if (list->len > 0)
+    ssd1306_write(ssd, list->buffer, list->len + 1);
+}
+
+static void ssd1306_send_commands(ssd1306_t *ssd, const uint8_t *commands, uint8_t count) {
+  ssd1306_cmd_list_t list;
+  ssd1306_cmd_list_init(&list);
+  ssd1306_cmd_list_add_bytes(&list, commands, count);
+  ssd1306_cmd_list_send(ssd, &list);
+}
+
+void ssd1306_set_contrast(ssd1306_t *ssd, uint8_t contrast) {
+  uint8_t commands[] = {SET_CONTRAST, contrast};
+  ssd1306_send_commands(ssd, commands, sizeof(commands));
+}
+
+void ssd1306_invert(ssd1306_t *ssd, bool invert) {
+  uint8_t commands[] = {SET_NORM_INV | (invert ? 0x01 : 0x00)};
+  ssd1306_send_commands(ssd, commands, sizeof(commands));
+}
+
+void ssd1306_display_on(ssd1306_t *ssd, bool on) {
+  uint8_t commands[] = {SET_DISP | (on ? 0x01 : 0x00)};
+  ssd1306_send_commands(ssd, commands, sizeof(commands));
+}
+
+// Rolagem horizontal contínua das páginas page0..page1. `interval` é o
+// código de 3 bits do datasheet (0 = 5 quadros ... 7 = 2 quadros por passo).
+void ssd1306_scroll_horizontal(ssd1306_t *ssd, bool left, uint8_t page0, uint8_t page1, uint8_t interval) {
+  uint8_t commands[] = {
+    SET_SCROLL_OFF,
+    left ? SET_HSCROLL_LEFT : SET_HSCROLL_RIGHT,
+    0x00, page0 & 0x07, interval & 0x07, page1 & 0x07, 0x00, 0xFF,
+    SET_SCROLL_ON
+  };
+  ssd1306_send_commands(ssd, commands, sizeof(commands));
+}
+
+// Após desativar a rolagem o conteúdo da RAM do display deve ser reenviado
+void ssd1306_scroll_stop(ssd1306_t *ssd) {
+  uint8_t commands[] = {SET_SCROLL_OFF};
+  ssd1306_send_commands(ssd, commands, sizeof(commands));
+  ssd->shadow_valid = false;
+}
+
+// Buffer de transmissão: cada byte do barramento vira uma palavra para o
+// registrador IC_DATA_CMD, e o bit STOP encerra cada transação. O DMA lê
+// daqui enquanto a aplicação continua desenhando em ram_buffer.
+static inline void ssd1306_stream_byte(ssd1306_t *ssd, uint8_t byte) {
+  ssd->stream[ssd->stream_len++] = byte;
+  ssd->flush_bytes++;
+}
+
+static inline void ssd1306_stream_stop(ssd1306_t *ssd) {
+  ssd->stream[ssd->stream_len - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+}
+
+// Endereçamento da janela numa única transação de comandos
+static void ssd1306_stream_window(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1) {
+  ssd1306_stream_byte(ssd, 0x00);
+  ssd1306_stream_byte(ssd, SET_COL_ADDR);
+  ssd1306_stream_byte(ssd, x0);
+  ssd1306_stream_byte(ssd, x1);
+  ssd1306_stream_byte(ssd, SET_PAGE_ADDR);
+  ssd1306_stream_byte(ssd, page0);
+  ssd1306_stream_byte(ssd, page1);
+  ssd1306_stream_stop(ssd);
+}
+
+static void ssd1306_clear_dirty(ssd1306_t *ssd) {
+  memset(ssd->dirty_x0, 0xFF, sizeof(ssd->dirty_x0));
+  memset(ssd->dirty_x1, 0x00, sizeof(ssd->dirty_x1));
+}
+
+// Marca como alterado o retângulo de colunas x0..x1 e páginas page0..page1
+void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1) {
+  for (uint8_t p = page0; p <= page1 && p < ssd->pages; ++p) {
+    if (x0 < ssd->dirty_x0[p])
+      ssd->dirty_x0[p] = x0;
+    if (x1 > ssd->dirty_x1[p])
+      ssd->dirty_x1[p] = x1;
+  }
+}
+
+// Copia uma janela retangular para o buffer de transmissão. O display está em
+// endereçamento vertical (SET_MEM_ADDR 0x01), então os bytes seguem coluna a
+// coluna, página a página.
+static void ssd1306_stream_data(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1) {
+  ssd1306_stream_window(ssd, x0, x1, page0, page1);
+  ssd1306_stream_byte(ssd, 0x40);
+  for (uint8_t x = x0; x <= x1; ++x) {
+    uint16_t index = x * ssd->pages + page0 + 1;
+    for (uint8_t p = page0; p <= page1; ++p, ++index) {
+      ssd1306_stream_byte(ssd, ssd->ram_buffer[index]);
+      ssd->shadow[index] = ssd->ram_buffer[index];
+    }
+  }
+  ssd1306_stream_stop(ssd);
+}
+
+// Monta no buffer de transmissão apenas o que mudou desde o último envio. As
+// faixas marcadas pelas primitivas são reduzidas comparando com o conteúdo
+// atual do display, e páginas vizinhas são agrupadas numa mesma janela quando
+// isso custa menos bytes do que abrir janelas separadas.
+static void ssd1306_build_frame(ssd1306_t *ssd, bool full) {
+  ssd->stream_len = 0;
+  ssd->flush_bytes = 0;
+  if (full || !ssd->shadow_valid) {
+    ssd1306_stream_data(ssd, 0, ssd->width - 1, 0, ssd->pages - 1);
+    ssd->shadow_valid = true;
+    ssd1306_clear_dirty(ssd);
+    return;
+  }
+
+  for (uint8_t p = 0; p < ssd->pages; ++p) {
+    uint8_t x0 = ssd->dirty_x0[p], x1 = ssd->dirty_x1[p];
+    while (x0 <= x1 && ssd->ram_buffer[x0 * ssd->pages + p + 1] == ssd->shadow[x0 * ssd->pages + p + 1])
+      ++x0;
+    while (x1 > x0 && ssd->ram_buffer[x1 * ssd->pages + p + 1] == ssd->shadow[x1 * ssd->pages + p + 1])
+      --x1;
+    ssd->dirty_x0[p] = x0;
+    ssd->dirty_x1[p] = x1;
+  }
+
+  int page0 = -1;
+  uint8_t wx0 = 0, wx1 = 0, page1 = 0;
+  for (uint8_t p = 0; p < ssd->pages; ++p) {
+    uint8_t x0 = ssd->dirty_x0[p], x1 = ssd->dirty_x1[p];
+    if (x0 > x1)
+      continue;
+    if (page0 >= 0 && p == page1 + 1) {
+      uint8_t mx0 = x0 < wx0 ? x0 : wx0;
+      uint8_t mx1 = x1 > wx1 ? x1 : wx1;
+      uint32_t merged = (mx1 - mx0 + 1) * (p - page0 + 1);
+      uint32_t separate = (wx1 - wx0 + 1) * (page1 - page0 + 1) + (x1 - x0 + 1) + SSD1306_WINDOW_OVERHEAD;
+      if (merged <= separate) {
+        wx0 = mx0;
+        wx1 = mx1;
+        page1 = p;
+        continue;
+      }
+    }
+    if (page0 >= 0)
+      ssd1306_stream_data(ssd, wx0, wx1, page0, page1);
+    page0 = p;
+    page1 = p;
+    wx0 = x0;
+    wx1 = x1;
+  }
+  if (page0 >= 0)
+    ssd1306_stream_data(ssd, wx0, wx1, page0, page1);
+
+  ssd1306_clear_dirty(ssd);
 }
 
+// Máquina de estados da transferência:
+//   IDLE -> SENDING   (present: DMA alimenta a FIFO de TX do I2C)
+//   SENDING -> DRAINING (IRQ do DMA: último byte já está na FIFO)
+//   DRAINING -> IDLE  (IRQ do I2C: STOP detectado com a FIFO vazia)
+static ssd1306_t *active_ssd = NULL;
+
+static void ssd1306_finish(ssd1306_t *ssd) {
+  if (ssd->state != SSD1306_DRAINING)
+    return;
+  i2c_get_hw(ssd->i2c_port)->intr_mask = 0;
+  ssd->state = SSD1306_IDLE;
+  ssd->transfer_us = time_us_32() - ssd->transfer_start_us;
+  ssd->frames_sent++;
+  if (ssd->on_complete)
+    ssd->on_complete(ssd);
+}
+
+static bool ssd1306_bus_idle(ssd1306_t *ssd) {
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  return (hw->status & I2C_IC_STATUS_TFE_BITS) && !(hw->status & I2C_IC_STATUS_ACTIVITY_BITS);
+}
+
+static void ssd1306_dma_irq_handler(void) {
+  ssd1306_t *ssd = active_ssd;
+  if (!ssd || !dma_channel_get_irq1_status(ssd->dma_channel))
+    return;
+  dma_channel_acknowledge_irq1(ssd->dma_channel);
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  ssd->state = SSD1306_DRAINING;
+  (void)hw->clr_stop_det;
+  hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS;
+  if (ssd1306_bus_idle(ssd))
+    ssd1306_finish(ssd);
+}
+
+static void ssd1306_i2c_irq_handler(void) {
+  ssd1306_t *ssd = active_ssd;
+  if (!ssd)
+    return;
+  (void)i2c_get_hw(ssd->i2c_port)->clr_stop_det;
+  if (ssd1306_bus_idle(ssd))
+    ssd1306_finish(ssd);
+}
+
+static void ssd1306_dma_init(ssd1306_t *ssd) {
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  hw->dma_tdlr = 8; // Pede dados com a FIFO pela metade, sem deixar o barramento parado
+  hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS;
+
+  ssd->dma_channel = dma_claim_unused_channel(true);
+  dma_channel_config c = dma_channel_get_default_config(ssd->dma_channel);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+  channel_config_set_read_increment(&c, true);
+  channel_config_set_write_increment(&c, false);
+  channel_config_set_dreq(&c, i2c_get_dreq(ssd->i2c_port, true));
+  dma_channel_configure(ssd->dma_channel, &c, &hw->data_cmd, ssd->stream, 0, false);
+  dma_channel_set_irq1_enabled(ssd->dma_channel, true);
+
+  active_ssd = ssd;
+  irq_add_shared_handler(DMA_IRQ_1, ssd1306_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+  irq_set_enabled(DMA_IRQ_1, true);
+  uint i2c_irq = I2C0_IRQ + i2c_hw_index(ssd->i2c_port);
+  irq_set_exclusive_handler(i2c_irq, ssd1306_i2c_irq_handler);
+  irq_set_enabled(i2c_irq, true);
+}
+
+static void ssd1306_start_transfer(ssd1306_t *ssd) {
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  hw->enable = 0;
+  hw->tar = ssd->address;
+  hw->enable = I2C_IC_ENABLE_ENABLE_BITS;
+  ssd->total_bytes += ssd->stream_len;
+  ssd->transfer_start_us = time_us_32();
+  ssd->state = SSD1306_SENDING;
+  dma_channel_transfer_from_buffer_now(ssd->dma_channel, ssd->stream, ssd->stream_len);
+}
+
+bool ssd1306_busy(ssd1306_t *ssd) {
+  return ssd->state != SSD1306_IDLE;
+}
+
+void ssd1306_wait(ssd1306_t *ssd) {
+  while (ssd1306_busy(ssd))
+    tight_loop_contents();
+}
+
+void ssd1306_set_callback(ssd1306_t *ssd, ssd1306_callback_t callback) {
+  ssd->on_complete = callback;
+}
+
+// Inicia o envio do quadro atual sem bloquear. Retorna false (e mantém as
+// regiões alteradas para o próximo envio) se ainda houver uma transferência
+// em andamento. Depois do retorno, ram_buffer pode ser alterado livremente.
+bool ssd1306_present(ssd1306_t *ssd) {
+  if (ssd1306_busy(ssd))
+    return false;
+  ssd1306_build_frame(ssd, false);
+  if (ssd->stream_len > 0)
+    ssd1306_start_transfer(ssd);
+  return true;
+}
+
+// Envio bloqueante do que mudou (compatível com o uso anterior)
 void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
-  );
+  ssd1306_wait(ssd);
+  ssd1306_present(ssd);
+  ssd1306_wait(ssd);
+}
+
+// Envio bloqueante do framebuffer inteiro
+void ssd1306_send_full(ssd1306_t *ssd) {
+  ssd1306_wait(ssd);
+  ssd1306_build_frame(ssd, true);
+  ssd1306_start_transfer(ssd);
+  ssd1306_wait(ssd);
 }
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
-  uint16_t index = (y >> 3) + (x << 3) + 1;
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+  uint8_t page = y >> 3;
+  if (x < ssd->dirty_x0[page])
+    ssd->dirty_x0[page] = x;
+  if (x > ssd->dirty_x1[page])
+    ssd->dirty_x1[page] = x;
+  uint16_t index = page + x * ssd->pages + 1;
   uint8_t pixel = (y & 0b111);
   if (value)
     ssd->ram_buffer[index] |= (1 << pixel);
@@ -77,44 +398,79 @@ void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
     ssd->ram_buffer[index] &= ~(1 << pixel);
 }
 
-/*
 void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
+  memset(ssd->ram_buffer + 1, value ? 0xFF : 0x00, ssd->bufsize - 1);
+  ssd1306_mark_dirty(ssd, 0, ssd->width - 1, 0, ssd->pages - 1);
+}
 
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
-    }
+// Aplica `mask` a um byte de página: liga ou desliga os bits marcados
+static inline void ssd1306_apply(uint8_t *byte, uint8_t mask, bool value) {
+  if (value)
+    *byte |= mask;
+  else
+    *byte &= ~mask;
 }
 
+// Preenche o retângulo de colunas x0..x1 e linhas y0..y1 (inclusivos, já
+// recortados) byte a byte: no layout vertical cada coluna é uma sequência
+// contígua de páginas, com máscaras apenas na primeira e na última.
+static void ssd1306_fill_span(ssd1306_t *ssd, int x0, int x1, int y0, int y1, bool value) {
+  uint8_t page0 = y0 >> 3, page1 = y1 >> 3;
+  uint8_t mask0 = 0xFF << (y0 & 7);
+  uint8_t mask1 = 0xFF >> (7 - (y1 & 7));
+  if (page0 == page1)
+    mask0 &= mask1;
+  uint8_t *column = &ssd->ram_buffer[x0 * ssd->pages + page0 + 1];
+  for (int x = x0; x <= x1; ++x, column += ssd->pages) {
+    ssd1306_apply(&column[0], mask0, value);
+    if (page1 == page0)
+      continue;
+    uint8_t *byte = &column[1];
+    for (uint8_t p = page0 + 1; p < page1; ++p)
+      *byte++ = value ? 0xFF : 0x00;
+    ssd1306_apply(byte, mask1, value);
+  }
+  ssd1306_mark_dirty(ssd, x0, x1, page0, page1);
+}
 
+// Recorta o retângulo à área do display; retorna false se ficar vazio
+static bool ssd1306_clip(ssd1306_t *ssd, int *x0, int *x1, int *y0, int *y1) {
+  if (*x0 > *x1 || *y0 > *y1 || *x1 < 0 || *y1 < 0 || *x0 >= ssd->width || *y0 >= ssd->height)
+    return false;
+  if (*x0 < 0) *x0 = 0;
+  if (*y0 < 0) *y0 = 0;
+  if (*x1 >= ssd->width) *x1 = ssd->width - 1;
+  if (*y1 >= ssd->height) *y1 = ssd->height - 1;
+  return true;
+}
 
-void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
-  for (uint8_t x = left; x < left + width; ++x) {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
-  }
-  for (uint8_t y = top; y < top + height; ++y) {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
-  }
+void ssd1306_fill_rect(ssd1306_t *ssd, int x0, int y0, int x1, int y1, bool value) {
+  if (ssd1306_clip(ssd, &x0, &x1, &y0, &y1))
+    ssd1306_fill_span(ssd, x0, x1, y0, y1, value);
+}
 
+void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+  if (width == 0 || height == 0)
+    return;
+  int right = left + width - 1;
+  int bottom = top + height - 1;
   if (fill) {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-        ssd1306_pixel(ssd, x, y, value);
-      }
-    }
+    ssd1306_fill_rect(ssd, left, top, right, bottom, value);
+    return;
   }
+  ssd1306_fill_rect(ssd, left, top, right, top, value);
+  ssd1306_fill_rect(ssd, left, bottom, right, bottom, value);
+  ssd1306_fill_rect(ssd, left, top, left, bottom, value);
+  ssd1306_fill_rect(ssd, right, top, right, bottom, value);
 }
 
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
+    // Linhas horizontais e verticais viram spans
+    if (y0 == y1 || x0 == x1) {
+        ssd1306_fill_rect(ssd, x0 < x1 ? x0 : x1, y0 < y1 ? y0 : y1, x0 < x1 ? x1 : x0, y0 < y1 ? y1 : y0, value);
+        return;
+    }
+
     int dx = abs(x1 - x0);
     int dy = abs(y1 - y0);
 
@@ -144,24 +500,29 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 
 
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
+  ssd1306_fill_rect(ssd, x0, y, x1, y, value);
 }
 
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  ssd1306_fill_rect(ssd, x, y0, x, y1, value);
 }
 
 // Função para desenhar um caractere
-void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
+// A fonte está em colunas de 8 bits (bit 0 no topo), o mesmo formato dos bytes
+// de página do display: com y múltiplo de 8 cada coluna é copiada inteira, e
+// nos demais casos é dividida em duas páginas vizinhas com deslocamento.
+// Roda da SRAM: o texto é a maior parte de cada tela.
+void __not_in_flash_func(ssd1306_draw_char)(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
 {
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+
   uint16_t index = 0;
 
   // Verifica o caractere e calcula o índice correspondente na fonte
   if (c >= ' ' && c <= '~') // Verifica se o caractere está na faixa ASCII válida
   {
-    index = (c - ' ') * 8; // Calcula o índice baseado na posição do caractere na tabela ASCII
+    index = (c - ' ') * FONT_WIDTH; // Calcula o índice baseado na posição do caractere na tabela ASCII
   }
   else
   {
@@ -169,15 +530,29 @@ void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
     index = 0; // Índice 0 corresponde ao caractere "nada" (espaço)
   }
 
-  // Desenha o caractere na tela
-  for (uint8_t i = 0; i < 8; ++i)
+  const uint8_t *glyph = &font[index];
+  uint8_t columns = (ssd->width - x) < 8 ? (ssd->width - x) : 8;
+  uint8_t page = y >> 3;
+  uint8_t shift = y & 7;
+  uint8_t *column = &ssd->ram_buffer[x * ssd->pages + page + 1];
+
+  if (shift == 0)
   {
-    uint8_t line = font[index + i]; // Acessa a linha correspondente do caractere na fonte
-    for (uint8_t j = 0; j < 8; ++j)
-    {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j)); // Desenha cada pixel do caractere
-    }
+    for (uint8_t i = 0; i < columns; ++i, column += ssd->pages)
+      *column = glyph[i];
+    ssd1306_mark_dirty(ssd, x, x + columns - 1, page, page);
+    return;
+  }
+
+  bool has_lower = page + 1 < ssd->pages;
+  uint8_t keep_upper = (1 << shift) - 1; // Bits acima do caractere na primeira página
+  for (uint8_t i = 0; i < columns; ++i, column += ssd->pages)
+  {
+    column[0] = (column[0] & keep_upper) | (glyph[i] << shift);
+    if (has_lower)
+      column[1] = (column[1] & ~keep_upper) | (glyph[i] >> (8 - shift));
   }
+  ssd1306_mark_dirty(ssd, x, x + columns - 1, page, has_lower ? page + 1 : page);
 }
 
 // Função para desenhar uma string
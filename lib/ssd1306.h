@@ -1,9 +1,20 @@
+#ifndef SSD1306_H
+#define SSD1306_H
+
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 
 #define WIDTH 128
 #define HEIGHT 64
+#define SSD1306_MAX_PAGES 8
+#define SSD1306_CMD_LIST_MAX 32
+
+// Buffers estáticos para um display de até WIDTH x HEIGHT: framebuffer e
+// cópia do último envio (byte de controle + páginas) e o stream do DMA, com o
+// pior caso de uma janela por página
+#define SSD1306_BUFSIZE (SSD1306_MAX_PAGES * WIDTH + 1)
+#define SSD1306_STREAM_WORDS (SSD1306_MAX_PAGES * (WIDTH + 1 + 7))
 
 typedef enum {
   SET_CONTRAST = 0x81,
@@ -22,28 +33,81 @@ typedef enum {
   SET_DISP_CLK_DIV = 0xD5,
   SET_PRECHARGE = 0xD9,
   SET_VCOM_DESEL = 0xDB,
-  SET_CHARGE_PUMP = 0x8D
+  SET_CHARGE_PUMP = 0x8D,
+  SET_HSCROLL_RIGHT = 0x26,
+  SET_HSCROLL_LEFT = 0x27,
+  SET_SCROLL_OFF = 0x2E,
+  SET_SCROLL_ON = 0x2F
 } ssd1306_command_t;
 
+// Lista de comandos enviada numa única transação, atrás de um só byte de
+// controle (0x00: Co = 0, D/C# = 0)
 typedef struct {
+  uint8_t buffer[SSD1306_CMD_LIST_MAX + 1];
+  uint8_t len;
+} ssd1306_cmd_list_t;
+
+typedef enum {
+  SSD1306_IDLE,      // Nenhuma transferência em andamento
+  SSD1306_SENDING,   // DMA alimentando a FIFO de TX do I2C
+  SSD1306_DRAINING   // DMA concluído, FIFO ainda esvaziando no barramento
+} ssd1306_state_t;
+
+typedef struct ssd1306 ssd1306_t;
+typedef void (*ssd1306_callback_t)(ssd1306_t *ssd);
+
+struct ssd1306 {
   uint8_t width, height, pages, address;
   i2c_inst_t *i2c_port;
   bool external_vcc;
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
-} ssd1306_t;
+  uint8_t *shadow;                       // Conteúdo atualmente no display (último envio)
+  uint16_t *stream;                      // Buffer de transmissão lido pelo DMA (palavras IC_DATA_CMD)
+  size_t stream_size, stream_len;
+  int dma_channel;
+  volatile ssd1306_state_t state;
+  ssd1306_callback_t on_complete;        // Chamado (no IRQ) ao fim de cada transferência
+  uint32_t frames_sent;
+  bool shadow_valid;                     // false até o primeiro envio completo
+  uint8_t dirty_x0[SSD1306_MAX_PAGES];   // Faixa de colunas alteradas por página
+  uint8_t dirty_x1[SSD1306_MAX_PAGES];   // (x0 > x1 indica página limpa)
+  uint32_t flush_bytes;                  // Bytes enviados pelo I2C no último envio
+  uint32_t total_bytes;                  // Bytes enviados desde a inicialização
+  uint32_t config_us;                    // Duração de ssd1306_config()
+  uint32_t transfer_start_us;
+  uint32_t transfer_us;                  // Duração da última transferência por DMA
+};
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
+void ssd1306_cmd_list_init(ssd1306_cmd_list_t *list);
+bool ssd1306_cmd_list_add(ssd1306_cmd_list_t *list, uint8_t command);
+bool ssd1306_cmd_list_add_bytes(ssd1306_cmd_list_t *list, const uint8_t *commands, uint8_t count);
+void ssd1306_cmd_list_send(ssd1306_t *ssd, const ssd1306_cmd_list_t *list);
+void ssd1306_set_contrast(ssd1306_t *ssd, uint8_t contrast);
+void ssd1306_invert(ssd1306_t *ssd, bool invert);
+void ssd1306_display_on(ssd1306_t *ssd, bool on);
+void ssd1306_scroll_horizontal(ssd1306_t *ssd, bool left, uint8_t page0, uint8_t page1, uint8_t interval);
+void ssd1306_scroll_stop(ssd1306_t *ssd);
 void ssd1306_send_data(ssd1306_t *ssd);
+void ssd1306_send_full(ssd1306_t *ssd);
+bool ssd1306_present(ssd1306_t *ssd);
+bool ssd1306_busy(ssd1306_t *ssd);
+void ssd1306_wait(ssd1306_t *ssd);
+void ssd1306_set_callback(ssd1306_t *ssd, ssd1306_callback_t callback);
+void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
+void ssd1306_fill_rect(ssd1306_t *ssd, int x0, int y0, int x1, int y1, bool value);
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill);
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value);
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
-void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
\ No newline at end of file
+void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+
+#endif
@@ -0,0 +1,58 @@
+#include "stats.h"
+
+void stats_reset(stats_t *s) {
+    s->n = 0;
+    s->sum = 0;
+    s->sum_sq = 0;
+}
+
+void stats_add_block(stats_t *s, uint32_t count, uint64_t sum, uint64_t sum_sq) {
+    s->n += count;
+    s->sum += sum;
+    s->sum_sq += sum_sq;
+}
+
+// Divide o peso acumulado por 2 mantendo média e variância (esquecimento)
+void stats_decay(stats_t *s) {
+    s->n >>= 1;
+    s->sum >>= 1;
+    s->sum_sq >>= 1;
+}
+
+// Média em Q8 (1/256 de código), truncada
+uint32_t stats_mean_q8(const stats_t *s) {
+    return s->n ? (uint32_t)((s->sum << 8) / s->n) : 0;
+}
+
+// Variância da média (var / n) em código² Q16; UINT64_MAX sem amostras suficientes.
+// var = (n * Σx² - (Σx)²) / (n * (n - 1)), dividindo por n antes de escalar.
+// O stats_decay trunca os três acumuladores separadamente e, com n pequeno,
+// a diferença pode ficar negativa: vale 0.
+uint64_t stats_mean_var_q16(const stats_t *s) {
+    if (s->n < 2)
+        return UINT64_MAX;
+    uint64_t n = s->n;
+    uint64_t a = n * s->sum_sq, b = s->sum * s->sum;
+    if (a <= b)
+        return 0;
+    uint64_t d = (a - b) / n;
+    return (d << 16) / ((n - 1) * n);
+}
+
+// Raiz quadrada inteira (piso), bit a bit: sem divisão nem float
+uint32_t stats_isqrt(uint64_t v) {
+    uint64_t r = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > v)
+        bit >>= 2;
+    while (bit) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
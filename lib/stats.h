@@ -0,0 +1,28 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+
+// Média e variância acumuladas bloco a bloco, em inteiros
+//
+// Em vez da recorrência de Welford em float, guarda soma e soma dos quadrados
+// exatas em 64 bits (códigos de 12 bits não perdem precisão), que é a forma
+// numericamente estável equivalente sem FPU. Blocos do DMA são combinados
+// diretamente somando os acumuladores.
+
+typedef struct {
+    uint32_t n;        // Amostras acumuladas
+    uint64_t sum;
+    uint64_t sum_sq;
+} stats_t;
+
+#define STATS_MAX_SAMPLES 65536u // Limite para os produtos caberem em 64 bits
+
+void stats_reset(stats_t *s);
+void stats_add_block(stats_t *s, uint32_t count, uint64_t sum, uint64_t sum_sq);
+void stats_decay(stats_t *s);
+uint32_t stats_mean_q8(const stats_t *s);
+uint64_t stats_mean_var_q16(const stats_t *s);
+uint32_t stats_isqrt(uint64_t v);
+
+#endif
@@ -0,0 +1,300 @@
+#include "telemetry.h"
+
+#define RING_MASK (TELEMETRY_RING_SIZE - 1)
+
+// Escrita de um pacote direto no anel, com o checksum calculado no caminho
+typedef struct {
+    telemetry_t *t;
+    uint32_t pos;
+    uint32_t sum1, sum2; // Fletcher-16 com redução só no fim (pacotes < 4 KB)
+} writer_t;
+
+static inline void put_raw(writer_t *w, uint8_t b) {
+    w->t->buf[w->pos++ & RING_MASK] = b;
+}
+
+static inline void put(writer_t *w, uint8_t b) {
+    put_raw(w, b);
+    w->sum1 += b;
+    w->sum2 += w->sum1;
+}
+
+static void put_u16(writer_t *w, uint16_t v) {
+    put(w, v & 0xFF);
+    put(w, v >> 8);
+}
+
+static void put_u32(writer_t *w, uint32_t v) {
+    put_u16(w, v & 0xFFFF);
+    put_u16(w, v >> 16);
+}
+
+void telemetry_init(telemetry_t *t) {
+    atomic_store(&t->head, 0);
+    atomic_store(&t->tail, 0);
+    t->seq = 0;
+    t->packets = 0;
+    t->dropped_packets = 0;
+    t->dropped_bytes = 0;
+}
+
+// Reserva espaço para o pacote inteiro e escreve o cabeçalho; false se não couber
+static bool begin(telemetry_t *t, writer_t *w, telemetry_type_t type, uint16_t payload) {
+    uint16_t seq = t->seq++;
+    uint32_t size = TELEMETRY_HEADER_BYTES + payload + TELEMETRY_TRAILER_BYTES;
+    uint32_t head = atomic_load_explicit(&t->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&t->tail, memory_order_acquire);
+    if (TELEMETRY_RING_SIZE - (head - tail) < size) {
+        t->dropped_packets++;
+        t->dropped_bytes += size;
+        return false;
+    }
+    w->t = t;
+    w->pos = head;
+    w->sum1 = 0;
+    w->sum2 = 0;
+    put_raw(w, TELEMETRY_SYNC0);
+    put_raw(w, TELEMETRY_SYNC1);
+    put(w, type);
+    put_u16(w, seq);
+    put_u16(w, payload);
+    return true;
+}
+
+// Fecha com o checksum e publica o pacote para o consumidor
+static void end(writer_t *w) {
+    uint16_t sum = (uint16_t)((w->sum2 % 255) << 8 | (w->sum1 % 255));
+    put_raw(w, sum & 0xFF);
+    put_raw(w, sum >> 8);
+    w->t->packets++;
+    atomic_store_explicit(&w->t->head, w->pos, memory_order_release);
+}
+
+// Amostras de 12 bits em pares: a[7:0], a[11:8] | b[3:0] << 4, b[11:4].
+// Número ímpar: a última vai com b = 0.
+bool telemetry_put_samples(telemetry_t *t, uint32_t block_seq, const uint16_t *samples, uint32_t count) {
+    writer_t w;
+    uint16_t packed = (uint16_t)((count + 1) / 2 * 3);
+    if (!begin(t, &w, TELEMETRY_SAMPLES, 6 + packed))
+        return false;
+    put_u32(&w, block_seq);
+    put_u16(&w, (uint16_t)count);
+    for (uint32_t i = 0; i < count; i += 2) {
+        uint16_t a = samples[i] & 0x0FFF;
+        uint16_t b = i + 1 < count ? samples[i + 1] & 0x0FFF : 0;
+        put(&w, a & 0xFF);
+        put(&w, (a >> 8) | (b & 0x0F) << 4);
+        put(&w, b >> 4);
+    }
+    end(&w);
+    return true;
+}
+
+// Nibbles de um bloco no formato de diferenças (sem a primeira amostra)
+static uint32_t delta_nibbles(const uint16_t *samples, uint32_t count) {
+    uint32_t n = 0;
+    for (uint32_t i = 1; i < count; i++) {
+        int32_t d = (int32_t)(samples[i] & 0x0FFF) - (int32_t)(samples[i - 1] & 0x0FFF);
+        n += d >= -7 && d <= 7 ? 1 : 4;
+    }
+    return n;
+}
+
+typedef struct {
+    writer_t *w;
+    uint8_t pending;
+    bool half;
+} nibble_writer_t;
+
+static inline void put_nibble(nibble_writer_t *nw, uint8_t v) {
+    if (nw->half) {
+        put(nw->w, nw->pending | (v << 4));
+        nw->half = false;
+    } else {
+        nw->pending = v & 0x0F;
+        nw->half = true;
+    }
+}
+
+// Bloco gravado (todas as amostras, com o instante do IRQ): diferenças em
+// nibbles quando ficam menores que os pares de 12 bits
+bool telemetry_put_block(telemetry_t *t, uint32_t block_seq, uint32_t time_us, const uint16_t *samples, uint32_t count) {
+    writer_t w;
+    uint32_t packed = (count + 1) / 2 * 3;
+    uint32_t delta = count ? 2 + (delta_nibbles(samples, count) + 1) / 2 : 0;
+    uint8_t format = count && delta < packed ? TELEMETRY_BLOCK_DELTA : TELEMETRY_BLOCK_PACKED;
+    if (!begin(t, &w, TELEMETRY_BLOCK, 11 + (format == TELEMETRY_BLOCK_DELTA ? delta : packed)))
+        return false;
+    put_u32(&w, block_seq);
+    put_u32(&w, time_us);
+    put_u16(&w, (uint16_t)count);
+    put(&w, format);
+    if (format == TELEMETRY_BLOCK_PACKED) {
+        for (uint32_t i = 0; i < count; i += 2) {
+            uint16_t a = samples[i] & 0x0FFF;
+            uint16_t b = i + 1 < count ? samples[i + 1] & 0x0FFF : 0;
+            put(&w, a & 0xFF);
+            put(&w, (a >> 8) | (b & 0x0F) << 4);
+            put(&w, b >> 4);
+        }
+    } else {
+        nibble_writer_t nw = {&w, 0, false};
+        put_u16(&w, samples[0] & 0x0FFF);
+        for (uint32_t i = 1; i < count; i++) {
+            uint16_t s = samples[i] & 0x0FFF;
+            int32_t d = (int32_t)s - (int32_t)(samples[i - 1] & 0x0FFF);
+            if (d >= -7 && d <= 7) {
+                put_nibble(&nw, (uint8_t)d & 0x0F);
+            } else {
+                put_nibble(&nw, 0x8);
+                put_nibble(&nw, s & 0x0F);
+                put_nibble(&nw, (s >> 4) & 0x0F);
+                put_nibble(&nw, s >> 8);
+            }
+        }
+        if (nw.half)
+            put(&w, nw.pending);
+    }
+    end(&w);
+    return true;
+}
+
+bool telemetry_put_event(telemetry_t *t, const telemetry_event_t *e) {
+    writer_t w;
+    if (!begin(t, &w, TELEMETRY_EVENT, TELEMETRY_EVENT_BYTES))
+        return false;
+    put_u32(&w, e->block);
+    put_u32(&w, e->time_us);
+    put(&w, e->type);
+    put(&w, e->value);
+    end(&w);
+    return true;
+}
+
+bool telemetry_put_session(telemetry_t *t, const telemetry_session_t *s) {
+    writer_t w;
+    if (!begin(t, &w, TELEMETRY_SESSION, TELEMETRY_SESSION_BYTES))
+        return false;
+    put(&w, s->version);
+    put(&w, s->channels);
+    put(&w, s->phase);
+    put(&w, s->series);
+    put(&w, s->mode);
+    put_u32(&w, s->rate_hz);
+    put_u32(&w, s->block);
+    for (int c = 0; c < TELEMETRY_CHANNELS; c++)
+        put_u32(&w, s->r_known_mohm[c]);
+    put_u32(&w, (uint32_t)s->offset_q4);
+    put_u16(&w, s->lin_first);
+    put_u16(&w, s->lin_last);
+    end(&w);
+    return true;
+}
+
+// Trecho da tabela de linearidade (centro de cada código em Q4)
+bool telemetry_put_cal(telemetry_t *t, uint16_t first, const uint16_t *center_q4, uint16_t count) {
+    writer_t w;
+    if (!begin(t, &w, TELEMETRY_CAL, 4 + 2u * count))
+        return false;
+    put_u16(&w, first);
+    put_u16(&w, count);
+    for (uint16_t i = 0; i < count; i++)
+        put_u16(&w, center_q4[i]);
+    end(&w);
+    return true;
+}
+
+static uint32_t get_u16(const uint8_t *p) {
+    return p[0] | (uint32_t)p[1] << 8;
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return get_u16(p) | get_u16(p + 2) << 16;
+}
+
+static inline uint8_t nibble(const uint8_t *data, uint32_t k) {
+    return (data[k / 2] >> (k & 1 ? 4 : 0)) & 0x0F;
+}
+
+// Payload de um TELEMETRY_BLOCK de volta em amostras; retorna quantas (0 se
+// o payload estiver truncado ou não couber em `max`)
+uint32_t telemetry_unpack_block(const uint8_t *payload, uint32_t len, uint32_t *block_seq, uint32_t *time_us,
+                                uint16_t *samples, uint32_t max) {
+    if (len < 11)
+        return 0;
+    *block_seq = get_u32(payload);
+    *time_us = get_u32(payload + 4);
+    uint32_t count = get_u16(payload + 8);
+    uint8_t format = payload[10];
+    const uint8_t *data = payload + 11;
+    len -= 11;
+    if (count == 0 || count > max)
+        return 0;
+    if (format == TELEMETRY_BLOCK_PACKED) {
+        if (len < (count + 1) / 2 * 3)
+            return 0;
+        for (uint32_t i = 0; i < count; i += 2, data += 3) {
+            samples[i] = data[0] | (data[1] & 0x0F) << 8;
+            if (i + 1 < count)
+                samples[i + 1] = data[1] >> 4 | data[2] << 4;
+        }
+        return count;
+    }
+    if (format != TELEMETRY_BLOCK_DELTA || len < 2)
+        return 0;
+    samples[0] = get_u16(data) & 0x0FFF;
+    uint32_t nibbles = (len - 2) * 2, k = 0;
+    data += 2;
+    for (uint32_t i = 1; i < count; i++) {
+        if (k >= nibbles)
+            return 0;
+        uint8_t v = nibble(data, k++);
+        if (v == 0x8) {
+            if (k + 3 > nibbles)
+                return 0;
+            samples[i] = nibble(data, k) | nibble(data, k + 1) << 4 | nibble(data, k + 2) << 8;
+            k += 3;
+        } else {
+            int32_t d = v & 0x8 ? (int32_t)v - 16 : v;
+            samples[i] = (samples[i - 1] + d) & 0x0FFF;
+        }
+    }
+    return count;
+}
+
+bool telemetry_put_reading(telemetry_t *t, const telemetry_reading_t *r) {
+    writer_t w;
+    if (!begin(t, &w, TELEMETRY_READING, TELEMETRY_READING_BYTES))
+        return false;
+    put_u32(&w, r->r_x_mohm);
+    put_u32(&w, r->closest_mohm);
+    put_u32(&w, r->incerteza_mohm);
+    put_u32(&w, r->media_q8);
+    put_u32(&w, r->amostras);
+    put_u32(&w, r->dropped_packets);
+    put_u32(&w, r->adc_overruns);
+    put(&w, r->estado);
+    put(&w, r->series);
+    put(&w, r->canal);
+    end(&w);
+    return true;
+}
+
+uint32_t telemetry_pending(telemetry_t *t) {
+    return atomic_load_explicit(&t->head, memory_order_acquire) - atomic_load_explicit(&t->tail, memory_order_relaxed);
+}
+
+// Trecho contíguo pronto para envio (até o fim do buffer ou do que há)
+uint32_t telemetry_peek(telemetry_t *t, const uint8_t **data) {
+    uint32_t tail = atomic_load_explicit(&t->tail, memory_order_relaxed);
+    uint32_t pending = atomic_load_explicit(&t->head, memory_order_acquire) - tail;
+    uint32_t contiguous = TELEMETRY_RING_SIZE - (tail & RING_MASK);
+    *data = &t->buf[tail & RING_MASK];
+    return pending < contiguous ? pending : contiguous;
+}
+
+// Só o consumidor escreve tail: load + store basta (o M0+ não tem RMW atômico)
+void telemetry_consume(telemetry_t *t, uint32_t n) {
+    uint32_t tail = atomic_load_explicit(&t->tail, memory_order_relaxed);
+    atomic_store_explicit(&t->tail, tail + n, memory_order_release);
+}
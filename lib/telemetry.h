@@ -0,0 +1,126 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Telemetria binária: pacotes com enquadramento e número de sequência num
+// anel de bytes, lidos direto do anel pelo endpoint CDC da USB
+//
+// Um produtor (core 1: IRQ do DMA e tarefa de aquisição, com o IRQ mascarado
+// na tarefa) e um consumidor (core 0). O pacote entra inteiro ou é
+// descartado e contado; a sequência avança mesmo no descarte, então o host
+// vê a lacuna. Formato (little-endian):
+//
+//   A5 5A | tipo | seq u16 | tamanho u16 | payload | fletcher16 u16
+//
+// O Fletcher-16 cobre de tipo até o fim do payload.
+//   TELEMETRY_SAMPLES: bloco u32, n u16, n amostras de 12 bits (2 em 3 bytes)
+//   TELEMETRY_READING: telemetry_reading_t campo a campo
+//
+// Gravação de sessão (todos os blocos, para reprodução no host):
+//   TELEMETRY_SESSION: telemetry_session_t campo a campo, no início
+//   TELEMETRY_CAL: primeiro código u16, n u16, n centros (Q4) u16 da
+//     tabela de linearidade, em pedaços de TELEMETRY_CAL_CHUNK
+//   TELEMETRY_BLOCK: bloco u32, tempo_us u32, n u16, formato u8, amostras.
+//     Formato 0: 12 bits em pares, como TELEMETRY_SAMPLES. Formato 1: a
+//     primeira amostra em u16 e as demais como diferença para a anterior
+//     em um nibble (-7 a 7; 0x8 escapa para o código em 3 nibbles), nibble
+//     baixo primeiro. Com o ruído de poucos códigos do divisor o bloco cai
+//     para ~0,5 byte por amostra; o formato menor é escolhido por bloco.
+//   TELEMETRY_EVENT: telemetry_event_t campo a campo (toques nos botões,
+//     antes do bloco em que o core 1 os viu)
+
+#define TELEMETRY_RING_SIZE 16384u // Potência de 2 (~50 ms do fluxo bruto)
+#define TELEMETRY_SYNC0 0xA5
+#define TELEMETRY_SYNC1 0x5A
+#define TELEMETRY_HEADER_BYTES 7
+#define TELEMETRY_TRAILER_BYTES 2
+
+typedef enum {
+    TELEMETRY_SAMPLES = 1,
+    TELEMETRY_READING = 2,
+    TELEMETRY_BLOCK = 3,
+    TELEMETRY_EVENT = 4,
+    TELEMETRY_SESSION = 5,
+    TELEMETRY_CAL = 6,
+} telemetry_type_t;
+
+#define TELEMETRY_BLOCK_PACKED 0   // Formatos de TELEMETRY_BLOCK
+#define TELEMETRY_BLOCK_DELTA 1
+#define TELEMETRY_CAL_CHUNK 1024   // Códigos por pacote TELEMETRY_CAL
+#define TELEMETRY_CHANNELS 3       // Canais descritos na sessão
+#define TELEMETRY_SESSION_VERSION 1
+
+// Leitura calculada, com os contadores de descarte para o host
+typedef struct {
+    uint32_t r_x_mohm;
+    uint32_t closest_mohm;
+    uint32_t incerteza_mohm;
+    uint32_t media_q8;
+    uint32_t amostras;
+    uint32_t dropped_packets;
+    uint32_t adc_overruns;
+    uint8_t estado;
+    uint8_t series;
+    uint8_t canal;          // Divisor da leitura (varredura)
+} telemetry_reading_t;
+
+#define TELEMETRY_READING_BYTES 31
+
+// Início de uma gravação: o que a reprodução precisa para partir do mesmo
+// estado do firmware (os canais são reiniciados nesse ponto)
+typedef struct {
+    uint8_t version;
+    uint8_t channels;       // CANAIS do firmware
+    uint8_t phase;          // Canal da primeira amostra do primeiro bloco
+    uint8_t series;         // Série E selecionada
+    uint8_t mode;           // Modo de exibição
+    uint32_t rate_hz;       // Taxa total do ADC
+    uint32_t block;         // Número do primeiro bloco gravado
+    uint32_t r_known_mohm[TELEMETRY_CHANNELS];
+    int32_t offset_q4;
+    uint16_t lin_first, lin_last;
+} telemetry_session_t;
+
+#define TELEMETRY_SESSION_BYTES 33
+
+typedef enum {
+    TELEMETRY_EVENT_BUTTON_A = 1,   // Troca de modo (valor: modo novo)
+    TELEMETRY_EVENT_BUTTON_JOY = 2, // Troca de série (valor: série nova)
+} telemetry_event_type_t;
+
+typedef struct {
+    uint32_t block;         // Próximo bloco gravado
+    uint32_t time_us;       // Instante do toque
+    uint8_t type;
+    uint8_t value;
+} telemetry_event_t;
+
+#define TELEMETRY_EVENT_BYTES 10
+
+typedef struct {
+    uint8_t buf[TELEMETRY_RING_SIZE];
+    _Atomic uint32_t head;   // Escrito só pelo produtor (contador livre)
+    _Atomic uint32_t tail;   // Escrito só pelo consumidor
+    uint16_t seq;
+    uint32_t packets;        // Pacotes enfileirados
+    uint32_t dropped_packets; // Descartados por falta de espaço
+    uint32_t dropped_bytes;
+} telemetry_t;
+
+void telemetry_init(telemetry_t *t);
+bool telemetry_put_samples(telemetry_t *t, uint32_t block_seq, const uint16_t *samples, uint32_t count);
+bool telemetry_put_reading(telemetry_t *t, const telemetry_reading_t *r);
+bool telemetry_put_block(telemetry_t *t, uint32_t block_seq, uint32_t time_us, const uint16_t *samples, uint32_t count);
+bool telemetry_put_event(telemetry_t *t, const telemetry_event_t *e);
+bool telemetry_put_session(telemetry_t *t, const telemetry_session_t *s);
+bool telemetry_put_cal(telemetry_t *t, uint16_t first, const uint16_t *center_q4, uint16_t count);
+uint32_t telemetry_unpack_block(const uint8_t *payload, uint32_t len, uint32_t *block_seq, uint32_t *time_us,
+                                uint16_t *samples, uint32_t max);
+uint32_t telemetry_pending(telemetry_t *t);
+uint32_t telemetry_peek(telemetry_t *t, const uint8_t **data);
+void telemetry_consume(telemetry_t *t, uint32_t n);
+
+#endif
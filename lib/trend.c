@@ -0,0 +1,68 @@
+#include "trend.h"
+#include <string.h>
+
+void trend_init(trend_t *t) {
+    memset(t, 0, sizeof(*t));
+}
+
+uint32_t trend_at(const trend_t *t, uint32_t column) {
+    return t->values[column % TREND_POINTS];
+}
+
+// Mínimo e máximo dos pontos válidos do histórico; false se não há nenhum
+bool trend_range(const trend_t *t, uint32_t *min, uint32_t *max) {
+    uint32_t n = t->count < TREND_POINTS ? t->count : TREND_POINTS;
+    bool any = false;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t v = t->values[i];
+        if (v == 0)
+            continue;
+        if (!any || v < *min)
+            *min = v;
+        if (!any || v > *max)
+            *max = v;
+        any = true;
+    }
+    return any;
+}
+
+static void trend_rescale(trend_t *t, uint32_t min, uint32_t max) {
+    uint32_t span = max - min;
+    uint32_t min_span = max / TREND_MIN_SPAN_DIV + 1;
+    if (span < min_span) {
+        uint32_t extra = (min_span - span) / 2;
+        min = min > extra ? min - extra : 0;
+        max = min + min_span;
+        span = min_span;
+    }
+    t->lo = min > span / 8 ? min - span / 8 : 0;
+    t->hi = max + span / 8;
+    t->rescales++;
+}
+
+// Acrescenta um ponto; true se a escala mudou (redesenhar tudo)
+bool trend_push(trend_t *t, uint32_t value) {
+    t->values[t->count % TREND_POINTS] = value;
+    t->count++;
+    uint32_t min, max;
+    if (!trend_range(t, &min, &max))
+        return false;
+    uint32_t span = t->hi - t->lo;
+    bool outside = min < t->lo || max > t->hi || span == 0;
+    uint32_t core = max - min > max / TREND_MIN_SPAN_DIV + 1 ? max - min : max / TREND_MIN_SPAN_DIV + 1;
+    bool too_wide = core < span / 4; // Faixa nova seria menos da metade da atual
+    if (!outside && !too_wide)
+        return false;
+    trend_rescale(t, min, max);
+    return true;
+}
+
+// Linha do display para um valor, entre top (hi) e bottom (lo)
+int trend_y(const trend_t *t, uint32_t value, int top, int bottom) {
+    uint32_t span = t->hi - t->lo;
+    if (span == 0 || value <= t->lo)
+        return bottom;
+    if (value >= t->hi)
+        return top;
+    return bottom - (int)((uint64_t)(value - t->lo) * (bottom - top) / span);
+}
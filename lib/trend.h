@@ -0,0 +1,32 @@
+#ifndef TREND_H
+#define TREND_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Histórico de R_x para o gráfico de tendência, em varredura: o ponto n vai
+// para a coluna n % TREND_POINTS, então cada ponto novo só altera a própria
+// coluna (e a faixa apagada à frente dela) no display
+//
+// A escala vertical acompanha o mínimo/máximo do histórico com margem de
+// 1/8; só muda quando um ponto sai da faixa ou quando o histórico (ou a
+// faixa mínima) passa a ocupar menos de 1/4 dela, e aí o gráfico inteiro é redesenhado. Valor 0
+// marca um ponto sem peça (coluna vazia).
+
+#define TREND_POINTS 128
+#define TREND_MIN_SPAN_DIV 500   // Faixa mínima = valor / 500 (0,2%), para o ruído não ocupar a tela
+
+typedef struct {
+    uint32_t values[TREND_POINTS];
+    uint32_t count;          // Pontos recebidos desde o início
+    uint32_t lo, hi;         // Escala atual (mΩ); lo == hi antes do primeiro ponto válido
+    uint32_t rescales;       // Mudanças de escala (redesenho completo)
+} trend_t;
+
+void trend_init(trend_t *t);
+bool trend_push(trend_t *t, uint32_t value);
+uint32_t trend_at(const trend_t *t, uint32_t column);
+bool trend_range(const trend_t *t, uint32_t *min, uint32_t *max);
+int trend_y(const trend_t *t, uint32_t value, int top, int bottom);
+
+#endif
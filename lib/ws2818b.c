@@ -1,5 +1,7 @@
+#include <string.h>
 #include "ws2818b.h"
 #include "ws2818b.pio.h"
+#include "hardware/dma.h"
 
 // MACRO
 #define LED_PIN 7
@@ -8,55 +10,96 @@
 // Matriz virtual 5x5
 #define MATRIX_SIZE 5
 
+// Tempo de um quadro: 24 bits de 1,25 us por LED, mais o reset (latch).
+// Versões recentes do WS2812B exigem 280 us de linha baixa para o latch.
+#define LED_BIT_NS 1250
+#define LED_RESET_US 300
+#define LED_FRAME_US ((LED_COUNT * 24 * LED_BIT_NS) / 1000 + LED_RESET_US)
+
 PIO np_pio;
 uint sm;
-struct pixel_t {
-    uint8_t G, R, B;
-};
-typedef struct pixel_t npLED_t;
+
+// Cada LED é uma palavra GRB de 24 bits alinhada à esquerda (G nos bits
+// 31..24), no formato consumido pela PIO com deslocamento à esquerda
+typedef uint32_t npLED_t;
 npLED_t leds[LED_COUNT];
 
+static uint32_t led_tx[LED_COUNT];   // Quadro em transmissão (lido pelo DMA)
+static bool led_tx_valid = false;    // led_tx contém o último quadro enviado
+static int led_dma_chan;
+static uint64_t led_ready_at = 0;    // Fim do quadro anterior + latch
+uint32_t led_frames_sent = 0;
+uint32_t led_frames_skipped = 0;
+
+static inline npLED_t pack_grb(uint8_t r, uint8_t g, uint8_t b) {
+    return ((uint32_t)g << 24) | ((uint32_t)r << 16) | ((uint32_t)b << 8);
+}
+
 void init_leds(void) {
     uint offset = pio_add_program(pio0, &ws2818b_program);
     np_pio = pio0;
     sm = pio_claim_unused_sm(np_pio, true);
     ws2818b_program_init(np_pio, sm, offset, LED_PIN, 800000.f);
-    for (int i = 0; i < LED_COUNT; i++) {
-        leds[i].R = leds[i].G = leds[i].B = 0;
-    }
+    clear_leds();
+
+    // DMA de palavras de 32 bits direto para a FIFO de TX da máquina de estados
+    led_dma_chan = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(led_dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(np_pio, sm, true));
+    dma_channel_configure(led_dma_chan, &c, &np_pio->txf[sm], led_tx, LED_COUNT, false);
 }
 
 // Limpa os LEDs
 void clear_leds(void) {
-    for (int i = 0; i < LED_COUNT; i++) {
-        leds[i].R = leds[i].G = leds[i].B = 0;
-    }
+    memset(leds, 0, sizeof(leds));
 }
 
-// Define a cor de um LED
-void set_led(int index, uint8_t r, uint8_t g, uint8_t b) {
+// Define a cor de um LED (da SRAM, como o restante do empacotamento GRB)
+void __not_in_flash_func(set_led)(int index, uint8_t r, uint8_t g, uint8_t b) {
     if (index < LED_COUNT) {
-        leds[index].R = r;
-        leds[index].G = g;
-        leds[index].B = b;
+        leds[index] = pack_grb(r, g, b);
     }
 }
 
 // Define a cor de todos os LEDs
-void set_all_leds(uint8_t r, uint8_t g, uint8_t b) {
+void __not_in_flash_func(set_all_leds)(uint8_t r, uint8_t g, uint8_t b) {
+    npLED_t color = pack_grb(r, g, b);
     for (int i = 0; i < LED_COUNT; i++) {
-        leds[i].R = r;
-        leds[i].G = g;
-        leds[i].B = b;
+        leds[i] = color;
+    }
+}
+
+// Indica se ainda há um quadro em transmissão ou no tempo de latch
+bool leds_busy(void) {
+    return time_us_64() < led_ready_at;
+}
+
+// Inicia o envio dos LEDs por DMA sem bloquear. Quadros iguais ao último
+// enviado são descartados. Retorna false se o quadro anterior (incluindo o
+// tempo de latch) ainda não terminou; nesse caso nada é enviado.
+bool write_leds_async(void) {
+    if (led_tx_valid && memcmp(led_tx, leds, sizeof(leds)) == 0) {
+        led_frames_skipped++;
+        return true;
     }
+    uint64_t now = time_us_64();
+    if (now < led_ready_at)
+        return false;
+    memcpy(led_tx, leds, sizeof(leds));
+    led_tx_valid = true;
+    led_ready_at = now + LED_FRAME_US;
+    led_frames_sent++;
+    dma_channel_transfer_from_buffer_now(led_dma_chan, led_tx, LED_COUNT);
+    return true;
 }
 
-// Escreve os LEDs
+// Escreve os LEDs, aguardando o fim do quadro anterior se necessário
 void write_leds(void) {
-    for (int i = 0; i < LED_COUNT; i++) {
-        pio_sm_put_blocking(np_pio, sm, leds[i].G);
-        pio_sm_put_blocking(np_pio, sm, leds[i].R);
-        pio_sm_put_blocking(np_pio, sm, leds[i].B);
+    while (!write_leds_async()) {
+        tight_loop_contents();
     }
 }
 
@@ -87,259 +130,55 @@ void display_joystick_position(int x_pos, int y_pos, uint8_t r, uint8_t g, uint8
     write_leds();
 }
 
-// Exibe um padrão predefinido na matriz de LEDs
-void display_pattern(uint8_t pattern) {
+// Padrões predefinidos: X, +, O, seta para cima e borda (demais valores)
+const led_glyph_t pattern_glyphs[LED_PATTERN_COUNT] = {
+    {0x1141051, 50, 0, 0},
+    {0x0427C84, 0, 50, 0},
+    {0x0E8C62E, 0, 0, 50},
+    {0x1F011C4, 50, 50, 0},
+    {0x1F8C63F, 15, 15, 15},
+};
+
+// Dígitos de 0 a 9
+const led_glyph_t number_glyphs[10] = {
+    {0x0E8C62E, 50, 0, 0},
+    {0x043108E, 0, 50, 0},
+    {0x1F87C3F, 0, 0, 15},
+    {0x1F83E1F, 15, 50, 0},
+    {0x0A53902, 15, 15, 0},
+    {0x1F0FE1F, 0, 0, 15},
+    {0x1F0FE3F, 0, 50, 15},
+    {0x1F41050, 10, 0, 10},
+    {0x1F8FE3F, 0, 10, 10},
+    {0x1F8FE1F, 0, 10, 10},
+};
+
+const led_glyph_t *pattern_glyph(uint8_t pattern) {
+    return &pattern_glyphs[pattern < LED_PATTERN_COUNT ? pattern : LED_PATTERN_COUNT - 1];
+}
+
+const led_glyph_t *number_glyph(int number) {
+    number %= 10; // Só o último dígito
+    return &number_glyphs[number < 0 ? -number : number];
+}
+
+// Desenha um padrão no buffer (sem enviar); os demais LEDs ficam apagados
+void __not_in_flash_func(draw_glyph)(const led_glyph_t *glyph) {
     clear_leds();
-    
-    switch (pattern) {
-        case 0:
-            // Padrão de "X"
-            set_led(0, 50, 0, 0);      // Canto superior esquerdo
-            set_led(4, 50, 0, 0);      // Canto superior direito
-            set_led(6, 50, 0, 0);      // Meio
-            set_led(12, 50, 0, 0);     // Centro
-            set_led(18, 50, 0, 0);     // Meio
-            set_led(20, 50, 0, 0);     // Canto inferior esquerdo
-            set_led(24, 50, 0, 0);     // Canto inferior direito
-            break;
-        case 1:
-            // Padrão de "+"
-            set_led(2, 0, 50, 0);      // Topo
-            set_led(7, 0, 50, 0);      // Meio superior
-            set_led(10, 0, 50, 0);     // Esquerda centro
-            set_led(11, 0, 50, 0);     // Meio esquerdo
-            set_led(12, 0, 50, 0);     // Centro
-            set_led(13, 0, 50, 0);     // Meio direito
-            set_led(14, 0, 50, 0);     // Direita centro
-            set_led(17, 0, 50, 0);     // Meio inferior
-            set_led(22, 0, 50, 0);     // Base
-            break;
-        case 2:
-            // Padrão de "O"
-            set_led(1, 0, 0, 50);      // Topo
-            set_led(2, 0, 0, 50);      // Topo
-            set_led(3, 0, 0, 50);      // Topo
-            set_led(5, 0, 0, 50);      // Esquerda
-            set_led(9, 0, 0, 50);      // Esquerda
-            set_led(10, 0, 0, 50);     // Topo-esquerda
-            set_led(14, 0, 0, 50);     // Topo-direita
-            set_led(15, 0, 0, 50);     // Direita
-            set_led(19, 0, 0, 50);     // Direita
-            set_led(21, 0, 0, 50);     // Base
-            set_led(22, 0, 0, 50);     // Base
-            set_led(23, 0, 0, 50);     // Base
-            break;
-        case 3:
-            // Padrão de seta para cima
-            for (int i = 20; i < 25; i++) {
-                set_led(i, 50, 50, 0);  // Base da seta (linha inferior)
-            }
-            set_led(12, 50, 50, 0);     // Centro da seta
-            set_led(7, 50, 50, 0);      // Subindo
-            set_led(2, 50, 50, 0);      // Topo da seta
-            set_led(6, 50, 50, 0);      // Lateral esquerda
-            set_led(8, 50, 50, 0);      // Lateral direita
-            break;
-        default:
-            // Padrao padrão: borda
-            for (int i = 0; i < MATRIX_SIZE; i++) {
-                // Bordas superior e inferior
-                set_led(i, 15, 15, 15);
-                set_led(i + (MATRIX_SIZE - 1) * MATRIX_SIZE, 15, 15, 15);
-                
-                // Bordas laterais
-                set_led(i * MATRIX_SIZE, 15, 15, 15);
-                set_led(i * MATRIX_SIZE + (MATRIX_SIZE - 1), 15, 15, 15);
-            }
-            break;
+    for (int i = 0; i < LED_COUNT; i++) {
+        if (glyph->mask & (1u << i))
+            set_led(i, glyph->r, glyph->g, glyph->b);
     }
-    
+}
+
+// Exibe um padrão predefinido na matriz de LEDs
+void display_pattern(uint8_t pattern) {
+    draw_glyph(pattern_glyph(pattern));
     write_leds();
 }
 
 // Exibe um número de 0 a 9 na matriz de LEDs
 void display_number(int number) {
-    clear_leds();
-    
-    // Certifique-se de que number está entre 0 e 9
-    number = number % 10;
-    
-    switch (number) {
-        case 0:
-            // Define os LEDs acesos para exibir o número 0
-            set_led(1, 50, 0, 0);
-            set_led(2, 50, 0, 0);
-            set_led(3, 50, 0, 0);
-            set_led(5, 50, 0, 0);
-            set_led(9, 50, 0, 0);
-            set_led(10, 50, 0, 0);
-            set_led(14, 50, 0, 0);
-            set_led(15, 50, 0, 0);
-            set_led(19, 50, 0, 0);
-            set_led(21, 50, 0, 0);
-            set_led(22, 50, 0, 0);
-            set_led(23, 50, 0, 0);
-            break;
-        case 1:
-            // Define os LEDs acesos para exibir o número 1
-            set_led(1, 0, 50, 0);
-            set_led(2, 0, 50, 0);
-            set_led(3, 0, 50, 0);
-            set_led(7, 0, 50, 0);
-            set_led(12, 0, 50, 0);
-            set_led(17, 0, 50, 0);
-            set_led(22, 0, 50, 0);
-            set_led(16, 0, 50, 0);
-            break;
-        case 2:
-            // Define os LEDs acesos para exibir o número 2
-            set_led(0, 0, 0,  15);
-            set_led(1, 0, 0,  15);
-            set_led(2, 0, 0,  15);
-            set_led(3, 0, 0,  15);
-            set_led(4, 0, 0,  15);
-            set_led(5, 0, 0,  15);
-            set_led(10, 0, 0, 15);
-            set_led(11, 0, 0, 15);
-            set_led(12, 0, 0, 15);
-            set_led(13, 0, 0, 15);
-            set_led(14, 0, 0, 15);
-            set_led(19, 0, 0, 15);
-            set_led(20, 0, 0, 15);
-            set_led(21, 0, 0, 15);
-            set_led(22, 0, 0, 15);
-            set_led(23, 0, 0, 15);
-            set_led(24, 0, 0, 15);
-            break;
-        case 3:
-            // Define os LEDs acesos para exibir o número 3
-            set_led(0, 15, 50, 0);
-            set_led(1, 15, 50, 0);
-            set_led(2, 15, 50, 0);
-            set_led(3, 15, 50, 0);
-            set_led(4, 15, 50, 0);
-            set_led(9, 15, 50, 0);
-            set_led(10, 15, 50, 0);
-            set_led(11, 15, 50, 0);
-            set_led(12, 15, 50, 0);
-            set_led(13, 15, 50, 0);
-            set_led(19, 15, 50, 0);
-            set_led(20, 15, 50, 0);
-            set_led(21, 15, 50, 0);
-            set_led(22, 15, 50, 0);
-            set_led(23, 15, 50, 0);
-            set_led(24, 15, 50, 0);
-            break;
-        case 4:
-            // Define os LEDs acesos para exibir o número 4
-            set_led(1, 15, 15, 0);
-            set_led(8, 15, 15, 0);
-            set_led(11, 15, 15, 0);
-            set_led(18, 15, 15, 0);
-            set_led(21, 15, 15, 0);
-            set_led(12, 15, 15, 0);
-            set_led(13, 15, 15, 0);
-            set_led(16, 15, 15, 0);
-            set_led(23, 15, 15, 0);
-            break;
-        case 5:
-            // Define os LEDs acesos para exibir o número 5
-            set_led(0, 0, 0,  15);
-            set_led(1, 0, 0,  15);
-            set_led(2, 0, 0,  15);
-            set_led(3, 0, 0,  15);
-            set_led(4, 0, 0,  15);
-            set_led(9, 0, 0,  15);
-            set_led(10, 0, 0, 15);
-            set_led(11, 0, 0, 15);
-            set_led(12, 0, 0, 15);
-            set_led(13, 0, 0, 15);
-            set_led(14, 0, 0, 15);
-            set_led(15, 0, 0, 15);
-            set_led(20, 0, 0, 15);
-            set_led(21, 0, 0, 15);
-            set_led(22, 0, 0, 15);
-            set_led(23, 0, 0, 15);
-            set_led(24, 0, 0, 15);
-            break;
-        case 6:
-            // Define os LEDs acesos para exibir o número 6
-            set_led(0, 0, 50, 15);
-            set_led(1, 0, 50, 15);
-            set_led(2, 0, 50, 15);
-            set_led(3, 0, 50, 15);
-            set_led(4, 0, 50, 15);
-            set_led(5, 0, 50, 15);
-            set_led(9, 0, 50, 15);
-            set_led(10, 0, 50, 15);
-            set_led(11, 0, 50, 15);
-            set_led(12, 0, 50, 15);
-            set_led(13, 0, 50, 15);
-            set_led(14, 0, 50, 15);
-            set_led(15, 0, 50, 15);
-            set_led(20, 0, 50, 15);
-            set_led(21, 0, 50, 15);
-            set_led(22, 0, 50, 15);
-            set_led(23, 0, 50, 15);
-            set_led(24, 0, 50, 15);
-            break;
-        case 7:
-            // Define os LEDs acesos para exibir o número 7
-            set_led(20, 10, 0, 10);
-            set_led(21, 10, 0, 10);
-            set_led(22, 10, 0, 10);
-            set_led(23, 10, 0, 10);
-            set_led(24, 10, 0, 10);
-            set_led(18, 10, 0, 10);
-            set_led(12, 10, 0, 10);
-            set_led(6, 10, 0, 10);
-            set_led(4, 10, 0, 10);
-            break;
-        case 8:
-            // Define os LEDs acesos para exibir o número 8
-            set_led(24, 0, 10, 10);
-            set_led(23, 0, 10, 10);
-            set_led(22, 0, 10, 10);
-            set_led(21, 0, 10, 10);
-            set_led(20, 0, 10, 10);
-            set_led(19, 0, 10, 10);
-            set_led(15, 0, 10, 10);
-            set_led(14, 0, 10, 10);
-            set_led(13, 0, 10, 10);
-            set_led(12, 0, 10, 10);
-            set_led(11, 0, 10, 10);
-            set_led(10, 0, 10, 10);
-            set_led(9, 0, 10, 10);
-            set_led(5, 0, 10, 10);
-            set_led(4, 0, 10, 10);
-            set_led(3, 0, 10, 10);
-            set_led(2, 0, 10, 10);
-            set_led(1, 0, 10, 10);
-            set_led(0, 0, 10, 10);
-            break;
-        case 9:
-            // Define os LEDs acesos para exibir o número 9
-            set_led(24, 0, 10, 10);
-            set_led(23, 0, 10, 10);
-            set_led(22, 0, 10, 10);
-            set_led(21, 0, 10, 10);
-            set_led(20, 0, 10, 10);
-            set_led(19, 0, 10, 10);
-            set_led(15, 0, 10, 10);
-            set_led(14, 0, 10, 10);
-            set_led(13, 0, 10, 10);
-            set_led(12, 0, 10, 10);
-            set_led(11, 0, 10, 10);
-            set_led(10, 0, 10, 10);
-            set_led(9, 0, 10, 10);
-            set_led(4, 0, 10, 10);
-            set_led(3, 0, 10, 10);
-            set_led(2, 0, 10, 10);
-            set_led(1, 0, 10, 10);
-            set_led(0, 0, 10, 10);
-            break;
-        default:
-            break;
-    }
+    draw_glyph(number_glyph(number));
     write_leds();
-} 
\ No newline at end of file
+}
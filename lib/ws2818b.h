@@ -7,14 +7,34 @@
 #define LED_PIN 7
 #define LED_COUNT 25
 
+#define LED_PATTERN_COUNT 5
+
+// Padrão de uma cor só na matriz: bit i aceso = LED i
+typedef struct {
+    uint32_t mask;
+    uint8_t r, g, b;
+} led_glyph_t;
+
+extern const led_glyph_t pattern_glyphs[LED_PATTERN_COUNT];
+extern const led_glyph_t number_glyphs[10];
+
+// Quadros enviados e quadros descartados por serem iguais ao anterior
+extern uint32_t led_frames_sent;
+extern uint32_t led_frames_skipped;
+
 // Declaração de funções
 void init_leds(void);
 void clear_leds(void);
 void set_led(int index, uint8_t r, uint8_t g, uint8_t b);
 void set_all_leds(uint8_t r, uint8_t g, uint8_t b);
 void write_leds(void);
+bool write_leds_async(void);
+bool leds_busy(void);
 void display_joystick_position(int x_pos, int y_pos, uint8_t r, uint8_t g, uint8_t b);
 void display_pattern(uint8_t pattern);
 void display_number(int number);
+const led_glyph_t *pattern_glyph(uint8_t pattern);
+const led_glyph_t *number_glyph(int number);
+void draw_glyph(const led_glyph_t *glyph);
 
 #endif 
\ No newline at end of file
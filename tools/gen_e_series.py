@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+"""Gera as tabelas de mantissas das séries E (IEC 60063) para lib/e_series.
+
+As séries E6/E12/E24 derivam da lista histórica da E24 (não seguem a
+fórmula). As séries E48/E96/E192 seguem round(100 * 10^(i/192)), com a
+exceção documentada da E192 (920 no lugar de 919), e E48/E96 são
+subconjuntos da E192.
+
+Uso: gen_e_series.py <saida.c>
+"""
+import sys
+
+E24 = [100, 110, 120, 130, 150, 160, 180, 200, 220, 240, 270, 300,
+       330, 360, 390, 430, 470, 510, 560, 620, 680, 750, 820, 910]
+
+E192_EXCEPTIONS = {919: 920}
+
+
+def e192():
+    values = [round(100 * 10 ** (i / 192)) for i in range(192)]
+    return [E192_EXCEPTIONS.get(v, v) for v in values]
+
+
+# (nome, mantissas, dígitos significativos, tolerância em décimos de %)
+SERIES = [
+    ("E6", E24[::4], 2, 200),
+    ("E12", E24[::2], 2, 100),
+    ("E24", E24, 2, 50),
+    ("E48", e192()[::4], 3, 20),
+    ("E96", e192()[::2], 3, 10),
+    ("E192", e192(), 3, 5),
+]
+
+
+def main():
+    out = []
+    out.append("// Gerado por tools/gen_e_series.py; não editar.")
+    out.append('#include "e_series.h"')
+    out.append("")
+    for name, values, _, _ in SERIES:
+        assert values == sorted(values) and len(set(values)) == len(values)
+        out.append("static const uint16_t mantissas_%s[] = {" % name)
+        for i in range(0, len(values), 12):
+            out.append("    " + ", ".join(str(v) for v in values[i:i + 12]) + ",")
+        out.append("};")
+        out.append("")
+    out.append("const e_series_t e_series_tables[E_SERIES_COUNT] = {")
+    for name, values, digits, tol in SERIES:
+        out.append('    {"%s", mantissas_%s, %d, %d, %d},' % (name, name, len(values), digits, tol))
+    out.append("};")
+    with open(sys.argv[1], "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""Uso de flash e RAM por módulo, a partir do mapa do link (GNU ld).
+
+Cada seção de entrada do mapa é somada ao arquivo objeto que a gerou. O que
+cai numa seção de saída carregada da flash conta como flash; o que fica numa
+região de RAM (RAM, SCRATCH_X/Y) conta como RAM. Por isso .data e o código
+marcado com __not_in_flash_func (.time_critical) contam nas duas: ficam na
+imagem e são copiados para a SRAM no boot. A coluna sram_code mostra só esse
+código.
+
+Os módulos do projeto aparecem pelo caminho do fonte; os do Pico SDK são
+agrupados por componente (sdk/hardware_adc, sdk/tinyusb...) e as bibliotecas
+da toolchain pelo arquivo (.a).
+
+Uso: size_report.py [--csv saida.csv] <firmware.elf.map>
+"""
+import argparse
+import re
+import sys
+
+SECTION_RE = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+load address 0x([0-9a-fA-F]+))?\s*$")
+VALUES_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+load address 0x([0-9a-fA-F]+))?\s*$")
+INPUT_RE = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+INPUT_VALUES_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+REGION_RE = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+
+SDK_DIRS = ("/src/rp2_common/", "/src/common/", "/src/rp2040/", "/src/boards/")
+
+
+def module_name(path):
+    """Nome do módulo dono de um objeto do mapa."""
+    archive = re.match(r"^(.*\.a)\((.*)\)$", path)
+    if archive:
+        return archive.group(1).rsplit("/", 1)[-1]
+    if "/lib/tinyusb/" in path:
+        return "sdk/tinyusb"
+    if any(d in path for d in SDK_DIRS):
+        return "sdk/" + path.rsplit("/", 2)[-2]
+    if ".dir/" in path:
+        path = path.split(".dir/", 1)[1]
+    for ext in (".obj", ".o"):
+        if path.endswith(ext):
+            path = path[: -len(ext)]
+    return path
+
+
+class Region:
+    def __init__(self, name, origin, length):
+        self.name = name
+        self.origin = origin
+        self.length = length
+
+    def contains(self, addr):
+        return self.origin <= addr < self.origin + self.length
+
+    @property
+    def is_ram(self):
+        return "RAM" in self.name.upper() or "SCRATCH" in self.name.upper()
+
+
+def region_of(regions, addr):
+    for r in regions:
+        if r.contains(addr):
+            return r
+    return None
+
+
+def classify(regions, name, vma, lma):
+    """(em_flash, em_ram) de uma seção de saída."""
+    if vma == 0 and lma is None:
+        return False, False  # Depuração, comentários etc.
+    if regions:
+        at = region_of(regions, vma)
+        load = region_of(regions, lma) if lma is not None else at
+        in_ram = at is not None and at.is_ram
+        in_flash = load is not None and not load.is_ram
+        return in_flash, in_ram
+    # Sem regiões (link do host): pelo nome
+    if name.startswith((".bss", ".tbss")):
+        return False, True
+    if name.startswith((".data", ".tdata")):
+        return True, True
+    return True, False
+
+
+def parse(lines):
+    regions = []
+    modules = {}
+    state = "start"
+    out = None           # (em_flash, em_ram) da seção de saída atual
+    pending_out = None   # Nome de seção de saída quebrado em duas linhas
+    pending_in = None    # Nome de seção de entrada quebrado em duas linhas
+
+    def add(path, section, size):
+        if size == 0 or out is None:
+            return
+        in_flash, in_ram = out
+        m = modules.setdefault(module_name(path), [0, 0, 0])
+        if in_flash:
+            m[0] += size
+        if in_ram:
+            m[1] += size
+            if section.startswith(".time_critical"):
+                m[2] += size
+
+    for line in lines:
+        line = line.rstrip("\n")
+        if line.startswith("Memory Configuration"):
+            state = "memory"
+            continue
+        if line.startswith("Linker script and memory map"):
+            state = "map"
+            continue
+        if state == "memory":
+            m = REGION_RE.match(line)
+            if m and m.group(1) not in ("Name", "*default*"):
+                regions.append(Region(m.group(1), int(m.group(2), 16), int(m.group(3), 16)))
+            continue
+        if state != "map":
+            continue
+
+        if pending_out is not None:
+            m = VALUES_RE.match(line)
+            name, pending_out = pending_out, None
+            if m:
+                lma = int(m.group(3), 16) if m.group(3) else None
+                out = classify(regions, name, int(m.group(1), 16), lma)
+                continue
+        if pending_in is not None:
+            m = INPUT_VALUES_RE.match(line)
+            section, pending_in = pending_in, None
+            if m:
+                add(m.group(3), section, int(m.group(2), 16))
+                continue
+
+        if line.startswith("."):
+            m = SECTION_RE.match(line)
+            if m:
+                lma = int(m.group(4), 16) if m.group(4) else None
+                out = classify(regions, m.group(1), int(m.group(2), 16), lma)
+            elif " " not in line.strip():
+                pending_out = line.strip()
+            else:
+                out = None
+            continue
+        if line.startswith(" ") and not line.startswith("  "):
+            if line.startswith(" *"):
+                continue  # Padrões do script e *fill*
+            m = INPUT_RE.match(line)
+            if m:
+                add(m.group(4), m.group(1), int(m.group(3), 16))
+            elif " " not in line.strip():
+                pending_in = line.strip()
+    return regions, modules
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("map", help="mapa do link (ex.: build/Teste_Voltimetro.elf.map)")
+    parser.add_argument("--csv", help="grava também modulo,flash,ram,sram_code neste arquivo")
+    args = parser.parse_args()
+
+    with open(args.map, encoding="utf-8", errors="replace") as f:
+        regions, modules = parse(f)
+    if not modules:
+        sys.exit("size_report: nenhuma seção encontrada em " + args.map)
+
+    rows = sorted(modules.items(), key=lambda kv: (-(kv[1][0] + kv[1][1]), kv[0]))
+    width = max(len(name) for name, _ in rows)
+    print(f"{'modulo':<{width}} {'flash':>8} {'ram':>8} {'sram_code':>9}")
+    for name, (flash, ram, code) in rows:
+        print(f"{name:<{width}} {flash:>8} {ram:>8} {code:>9}")
+    total = [sum(v[i] for v in modules.values()) for i in range(3)]
+    print(f"{'total':<{width}} {total[0]:>8} {total[1]:>8} {total[2]:>9}")
+
+    # Orçamento: total contra o tamanho das regiões do link
+    flash_len = sum(r.length for r in regions if not r.is_ram)
+    ram_len = sum(r.length for r in regions if r.is_ram)
+    if flash_len and ram_len:
+        print(f"flash {100.0 * total[0] / flash_len:.1f}% de {flash_len // 1024} KB, "
+              f"ram {100.0 * total[1] / ram_len:.1f}% de {ram_len // 1024} KB")
+
+    if args.csv:
+        with open(args.csv, "w", encoding="utf-8") as f:
+            f.write("modulo,flash,ram,sram_code\n")
+            for name, (flash, ram, code) in rows:
+                f.write(f"{name},{flash},{ram},{code}\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,215 @@
+#!/usr/bin/env python3
+"""Decodifica o fluxo binário de telemetria do ohmímetro (lib/telemetry).
+
+Lê de um arquivo, do dispositivo serial (ex.: /dev/ttyACM0, configurado com
+`stty -F /dev/ttyACM0 raw`) ou da entrada padrão (-). Ressincroniza pelos
+bytes A5 5A e pelo Fletcher-16, então texto do printf no meio do fluxo só
+custa os pacotes atingidos. Lacunas na sequência são pacotes descartados
+no anel do firmware.
+
+Também lê uma gravação de sessão ('g' no console): os blocos completos
+(TELEMETRY_BLOCK, compactados ou em diferenças) vão para o CSV de amostras
+e os toques nos botões para --events. A reprodução da sessão pelo código do
+firmware é feita por host/replay.c.
+
+Uso: telemetry_decode.py [--samples amostras.csv] [--readings leituras.csv]
+                         [--events toques.csv] [--check-ramp]
+                         <arquivo|dispositivo|->
+
+--check-ramp confere o fluxo gerado por host/telemetry_loopback: rampa das
+amostras, nenhum checksum errado e lacunas iguais ao total de descartes
+informado pela última leitura. Sai com código 1 se algo não bater.
+"""
+import argparse
+import struct
+import sys
+
+SYNC = b"\xa5\x5a"
+HEADER = 7
+TRAILER = 2
+SAMPLES = 1
+READING = 2
+BLOCK = 3
+EVENT = 4
+SESSION = 5
+CAL = 6
+READING_FMT = "<7IBBB"
+EVENT_FMT = "<IIBB"
+SESSION_FMT = "<5BII3IiHH"
+BLOCK_PACKED = 0
+BLOCK_DELTA = 1
+EVENT_NAMES = {1: "botao_a", 2: "joystick"}
+MAX_PAYLOAD = 4096
+
+
+def fletcher16(data):
+    s1 = s2 = 0
+    for b in data:
+        s1 = (s1 + b) % 255
+        s2 = (s2 + s1) % 255
+    return s2 << 8 | s1
+
+
+def unpack12(data, count):
+    out = []
+    for i in range(0, len(data) - 2, 3):
+        b0, b1, b2 = data[i], data[i + 1], data[i + 2]
+        out.append(b0 | (b1 & 0x0F) << 8)
+        out.append(b1 >> 4 | b2 << 4)
+    return out[:count]
+
+
+def unpack_block(payload):
+    """(bloco, tempo_us, códigos) de um TELEMETRY_BLOCK; None se inválido."""
+    block, time_us, count, fmt = struct.unpack_from("<IIHB", payload)
+    data = payload[11:]
+    if fmt == BLOCK_PACKED:
+        return block, time_us, unpack12(data, count)
+    if fmt != BLOCK_DELTA or len(data) < 2:
+        return None
+    codes = [struct.unpack_from("<H", data)[0] & 0x0FFF]
+    nibbles = []
+    for b in data[2:]:
+        nibbles += (b & 0x0F, b >> 4)
+    k = 0
+    while len(codes) < count:
+        if k >= len(nibbles):
+            return None
+        v = nibbles[k]
+        k += 1
+        if v == 0x8:
+            if k + 3 > len(nibbles):
+                return None
+            codes.append(nibbles[k] | nibbles[k + 1] << 4 | nibbles[k + 2] << 8)
+            k += 3
+        else:
+            codes.append((codes[-1] + (v - 16 if v & 0x8 else v)) & 0x0FFF)
+    return block, time_us, codes
+
+
+class Decoder:
+    def __init__(self):
+        self.buf = bytearray()
+        self.last_seq = None
+        self.packets = 0
+        self.gaps = 0
+        self.bad_checksum = 0
+        self.skipped_bytes = 0
+
+    def feed(self, data):
+        """Acrescenta bytes e devolve os pacotes completos (tipo, seq, payload)."""
+        self.buf += data
+        out = []
+        while True:
+            start = self.buf.find(SYNC)
+            if start < 0:
+                keep = 1 if self.buf[-1:] == SYNC[:1] else 0
+                self.skipped_bytes += len(self.buf) - keep
+                del self.buf[:len(self.buf) - keep]
+                return out
+            if start:
+                self.skipped_bytes += start
+                del self.buf[:start]
+            if len(self.buf) < HEADER:
+                return out
+            ptype, seq, length = struct.unpack_from("<BHH", self.buf, 2)
+            if length > MAX_PAYLOAD:
+                self._resync()
+                continue
+            total = HEADER + length + TRAILER
+            if len(self.buf) < total:
+                return out
+            body = bytes(self.buf[2:HEADER + length])
+            (checksum,) = struct.unpack_from("<H", self.buf, HEADER + length)
+            if fletcher16(body) != checksum:
+                self.bad_checksum += 1
+                self._resync()
+                continue
+            del self.buf[:total]
+            if self.last_seq is not None:
+                self.gaps += (seq - self.last_seq - 1) & 0xFFFF
+            self.last_seq = seq
+            self.packets += 1
+            out.append((ptype, seq, body[HEADER - 2:]))
+
+    def _resync(self):
+        # Pula o sincronismo falso e procura o próximo
+        self.skipped_bytes += 1
+        del self.buf[:1]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("source")
+    parser.add_argument("--samples", help="CSV de saída: bloco,indice,codigo")
+    parser.add_argument("--readings", help="CSV de saída das leituras")
+    parser.add_argument("--events", help="CSV de saída dos toques: bloco,tempo_us,botao,valor")
+    parser.add_argument("--check-ramp", action="store_true")
+    args = parser.parse_args()
+
+    src = sys.stdin.buffer if args.source == "-" else open(args.source, "rb", buffering=0)
+    samples_out = open(args.samples, "w") if args.samples else None
+    readings_out = open(args.readings, "w") if args.readings else None
+    events_out = open(args.events, "w") if args.events else None
+    if samples_out:
+        samples_out.write("bloco,indice,codigo\n")
+    if readings_out:
+        readings_out.write("seq,r_x_mohm,closest_mohm,incerteza_mohm,media_q8,amostras,"
+                           "descartados,overruns_adc,estado,serie,canal\n")
+    if events_out:
+        events_out.write("bloco,tempo_us,botao,valor\n")
+
+    dec = Decoder()
+    ramp_errors = 0
+    bad_blocks = 0
+    last_reading = None
+    try:
+        while True:
+            data = src.read(4096)
+            if not data:
+                break
+            for ptype, seq, payload in dec.feed(data):
+                if ptype in (SAMPLES, BLOCK):
+                    if ptype == SAMPLES:
+                        block, count = struct.unpack_from("<IH", payload)
+                        codes = unpack12(payload[6:], count)
+                    else:
+                        decoded = unpack_block(payload)
+                        if decoded is None:
+                            bad_blocks += 1
+                            continue
+                        block, _, codes = decoded
+                    if samples_out:
+                        samples_out.writelines(f"{block},{i},{c}\n" for i, c in enumerate(codes))
+                    if args.check_ramp:
+                        ramp_errors += sum(c != (block * 131 + i * 7) & 0x0FFF for i, c in enumerate(codes))
+                elif ptype == READING:
+                    last_reading = struct.unpack_from(READING_FMT, payload)
+                    if readings_out:
+                        readings_out.write(f"{seq}," + ",".join(map(str, last_reading)) + "\n")
+                elif ptype == EVENT:
+                    block, time_us, kind, value = struct.unpack_from(EVENT_FMT, payload)
+                    if events_out:
+                        events_out.write(f"{block},{time_us},{EVENT_NAMES.get(kind, kind)},{value}\n")
+                elif ptype == SESSION:
+                    s = struct.unpack_from(SESSION_FMT, payload)
+                    print(f"sessao v{s[0]}: {s[1]} canal(is), {s[5]} Hz, serie {s[3]}, modo {s[4]}, "
+                          f"bloco {s[6]}, R_conhecido {list(s[7:7 + s[1]])} mohm", file=sys.stderr)
+    except KeyboardInterrupt:
+        pass
+
+    dropped = last_reading[5] if last_reading else 0
+    print(f"pacotes {dec.packets}, lacunas {dec.gaps}, descartados (firmware) {dropped}, "
+          f"checksum errado {dec.bad_checksum}, bytes ignorados {dec.skipped_bytes}", file=sys.stderr)
+
+    if args.check_ramp:
+        ok = (dec.packets > 0 and ramp_errors == 0 and bad_blocks == 0 and dec.bad_checksum == 0
+              and dec.gaps == dropped)
+        print("loopback " + ("ok" if ok else f"FALHOU (amostras erradas {ramp_errors}, blocos invalidos {bad_blocks})"),
+              file=sys.stderr)
+        return 0 if ok else 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())